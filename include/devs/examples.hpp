@@ -9,7 +9,16 @@ namespace Examples {
 void minimal_atomic_simulation();
 void minimal_compound_simulation();
 void traffic_light_simulation();
+void traffic_light_grid_simulation();
+void traffic_light_batched_outputs_simulation();
 void queue_simulation_short();
+void queue_simulation_impatient();
+void queue_simulation_staffing();
+void queue_simulation_forecast();
 void queue_simulation_long();
 void queue_simulation_large();
+void queue_simulation_daily();
+void queue_simulation_replications();
+void queue_what_if_simulation();
+void network_layout_cache_simulation();
 } // namespace Examples
\ No newline at end of file
@@ -6,27 +6,136 @@
 #pragma once
 //----------------------------------------------------------------------------------------------------------------------
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//----------------------------------------------------------------------------------------------------------------------
+// per-event validation (scheduling into the past, self-influence), defaults to checked debug builds and unchecked
+// release (NDEBUG) builds, the dynamic type casts and the select results are checked in every build
+#ifndef DEVS_CHECKED
+#ifdef NDEBUG
+#define DEVS_CHECKED 0
+#else
+#define DEVS_CHECKED 1
+#endif
+#endif
+// USDT probes (provider "devs") for tracing runs with bpftrace/systemtap, a semaphore check each until attached
+// compiled in whenever <sys/sdt.h> is available, disabled by defining DEVS_USDT to 0
+#ifndef DEVS_USDT
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define DEVS_USDT 1
+#endif
+#endif
+#endif
+#if defined(DEVS_USDT) && DEVS_USDT
+// the attached tracers count themselves in the semaphore of a probe, the probe arguments (time conversion, names) are
+// only evaluated while the count is not zero
+#if !defined(_SYS_SDT_H) && !defined(_SDT_HAS_SEMAPHORES)
+#define _SDT_HAS_SEMAPHORES 1
+#endif
+#include <sys/sdt.h>
+#if defined(_SDT_HAS_SEMAPHORES) && _SDT_HAS_SEMAPHORES
+#define DEVS_SEMAPHORE(name)                                                                                           \
+    extern "C" {                                                                                                       \
+    inline volatile unsigned short devs_##name##_semaphore __attribute__((section(".probes"))) = 0;                    \
+    }
+#define DEVS_PROBE_ENABLED(name) (devs_##name##_semaphore != 0)
+DEVS_SEMAPHORE(event__schedule)
+DEVS_SEMAPHORE(event__execute)
+DEVS_SEMAPHORE(event__cancel)
+DEVS_SEMAPHORE(transition)
+DEVS_SEMAPHORE(message__route)
+#else
+// <sys/sdt.h> included before without semaphores
+#define DEVS_PROBE_ENABLED(name) true
+#endif
+#define DEVS_PROBE3(name, a1, a2, a3)                                                                                  \
+    do {                                                                                                               \
+        if (DEVS_PROBE_ENABLED(name)) {                                                                                \
+            DTRACE_PROBE3(devs, name, a1, a2, a3);                                                                     \
+        }                                                                                                              \
+    } while (false)
+#define DEVS_PROBE4(name, a1, a2, a3, a4)                                                                              \
+    do {                                                                                                               \
+        if (DEVS_PROBE_ENABLED(name)) {                                                                                \
+            DTRACE_PROBE4(devs, name, a1, a2, a3, a4);                                                                 \
+        }                                                                                                              \
+    } while (false)
+#else
+#define DEVS_PROBE3(name, a1, a2, a3)
+#define DEVS_PROBE4(name, a1, a2, a3, a4)
+#endif
 //----------------------------------------------------------------------------------------------------------------------
 namespace Devs {
 namespace Random {
 using Engine = std::mt19937_64;
 
 namespace _impl {
-inline Engine seeded_engine(const std::optional<int> seed) { return Engine{seed ? *seed : std::random_device{}()}; }
+// per-thread source of seeds for generators created without an explicit seed
+inline std::optional<Engine>& default_seed_engine() {
+    static thread_local std::optional<Engine> engine{};
+    return engine;
+}
+
+// the seed given to set_default_seed, shared by the threads deriving their own seeds from it (see seed_stream)
+inline std::optional<std::uint64_t>& default_seed_value() {
+    static std::optional<std::uint64_t> seed{};
+    return seed;
+}
+
+inline Engine seeded_engine(const std::optional<int> seed) {
+    if (seed) {
+        return Engine{static_cast<Engine::result_type>(*seed)};
+    }
+    if (auto& engine = default_seed_engine()) {
+        return Engine{(*engine)()};
+    }
+    return Engine{std::random_device{}()};
+}
 
 template <typename Ret, typename Dist> std::function<Ret()> generator(const std::optional<int> seed, Dist dist) {
     return [engine = seeded_engine(seed), dist = std::move(dist)]() mutable { return dist(engine); };
@@ -51,6 +160,142 @@ inline std::function<double()> exponential(const double rate, const std::optiona
     return _impl::generator<double>(seed, std::exponential_distribution<>{rate});
 }
 
+enum class Interpolation { CONSTANT, LINEAR };
+
+// breakpoint of a piecewise arrival rate profile, the offset is relative to the start of the profile period
+struct RatePoint {
+  public: // members
+    double offset;
+    double rate;
+};
+
+namespace _impl {
+// non-homogeneous Poisson process sampled by inverting its cumulative rate, every arrival consumes one unit
+// exponential draw and the segments are walked forward only (no rejected draws, amortized O(1) per arrival)
+class PiecewiseArrivals {
+  public: // ctors, dtor
+    PiecewiseArrivals(std::vector<RatePoint> profile, const Interpolation interpolation, const double start,
+                      const std::optional<int> seed)
+        : profile_{std::move(profile)}, interpolation_{interpolation}, engine_{seeded_engine(seed)},
+          cycle_start_{start}, time_{start} {
+        if (profile_.size() < 2 || profile_.front().offset != 0.0) {
+            throw std::runtime_error("Rate profile requires at least two breakpoints starting at offset 0");
+        }
+        double mass{};
+        for (size_t idx = 0; idx < profile_.size(); ++idx) {
+            if (profile_[idx].rate < 0.0) {
+                throw std::runtime_error("Rate profile contains a negative rate");
+            }
+            if (idx > 0 && profile_[idx].offset <= profile_[idx - 1].offset) {
+                throw std::runtime_error("Rate profile offsets have to be strictly increasing");
+            }
+            if (idx + 1 < profile_.size()) {
+                mass += segment_mass(idx, profile_[idx].offset);
+            }
+        }
+        empty_ = mass <= 0.0;
+    }
+
+  public: // methods
+    // next arrival time, infinity for a profile without arrivals
+    double operator()() {
+        if (empty_) {
+            return std::numeric_limits<double>::infinity();
+        }
+        auto needed = unit_(engine_);
+        while (true) {
+            const auto offset = time_ - cycle_start_;
+            const auto available = segment_mass(segment_, offset);
+            if (needed <= available) {
+                time_ = cycle_start_ + offset + invert(segment_, offset, needed);
+                return time_;
+            }
+            needed -= available;
+            next_segment();
+        }
+    }
+
+  private: // methods
+    double slope(const size_t idx) const {
+        if (interpolation_ == Interpolation::CONSTANT) {
+            return 0.0;
+        }
+        return (profile_[idx + 1].rate - profile_[idx].rate) / (profile_[idx + 1].offset - profile_[idx].offset);
+    }
+
+    double rate_at(const size_t idx, const double offset) const {
+        return profile_[idx].rate + slope(idx) * (offset - profile_[idx].offset);
+    }
+
+    // integrated rate from the offset until the end of the segment
+    double segment_mass(const size_t idx, const double offset) const {
+        const auto length = profile_[idx + 1].offset - offset;
+        return length * (rate_at(idx, offset) + 0.5 * slope(idx) * length);
+    }
+
+    // length after the offset over which the rate integrates to the mass
+    double invert(const size_t idx, const double offset, const double mass) const {
+        const auto rate = rate_at(idx, offset);
+        const auto b = slope(idx);
+        if (b == 0.0) {
+            return rate > 0.0 ? mass / rate : 0.0;
+        }
+        // solves rate * u + b * u^2 / 2 = mass in the cancellation free form
+        const auto denominator = rate + std::sqrt(std::max(0.0, rate * rate + 2.0 * b * mass));
+        return denominator > 0.0 ? 2.0 * mass / denominator : 0.0;
+    }
+
+    void next_segment() {
+        ++segment_;
+        if (segment_ + 1 == profile_.size()) {
+            // the profile repeats after its last breakpoint
+            segment_ = 0;
+            cycle_start_ += profile_.back().offset;
+        }
+        time_ = cycle_start_ + profile_[segment_].offset;
+    }
+
+  private: // members
+    std::vector<RatePoint> profile_;
+    Interpolation interpolation_;
+    Engine engine_;
+    std::exponential_distribution<> unit_{1.0};
+    double cycle_start_;
+    double time_;
+    size_t segment_{};
+    bool empty_{};
+};
+} // namespace _impl
+
+// arrival times of a non-homogeneous Poisson process following a periodic piecewise rate profile from the start
+// the last breakpoint ends the period, its rate is only used as the end point of LINEAR interpolation
+inline std::function<double()> piecewise_poisson_arrivals(std::vector<RatePoint> profile,
+                                                          const Interpolation interpolation, const double start = 0.0,
+                                                          const std::optional<int> seed = {}) {
+    return _impl::PiecewiseArrivals{std::move(profile), interpolation, start, seed};
+}
+
+// makes generators created afterwards on the calling thread without an explicit seed reproducible
+inline void set_default_seed(const std::uint64_t seed) {
+    _impl::default_seed_engine() = Engine{seed};
+    _impl::default_seed_value() = seed;
+}
+
+inline std::optional<std::uint64_t> default_seed() { return _impl::default_seed_value(); }
+
+// seeds the calling thread with a seed derived from the default seed and the index of an independent stream (e.g. a
+// replication run by a pool worker), so that the stream does not depend on the thread running it
+// without a default seed the generators of the thread stay seeded by std::random_device
+inline void seed_stream(const std::uint64_t stream) {
+    if (const auto seed = default_seed()) {
+        // splitmix64 finalizer over both, neighbouring streams get unrelated seeds
+        auto z = *seed + 0x9e3779b97f4a7c15ull * (stream + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        _impl::default_seed_engine() = Engine{z ^ (z >> 31)};
+    }
+}
+
 template <typename T = double> T rand() {
     static auto generator = uniform<T>();
     return generator();
@@ -72,6 +317,7 @@ class IBox {
     virtual ~IBox() = default;
 
   public: // static functions
+    // checked in every build, transformed couplings, external inputs and listeners are not validated upfront
     template <typename T> static T& ref(IBox& box) { return (dynamic_cast<Box<T>&>(box)).ref(); }
     template <typename T> static T value(const IBox& box) { return (dynamic_cast<const Box<T>&>(box)).value(); }
 
@@ -109,6 +355,8 @@ class Dynamic {
     template <typename T> Dynamic(const T value) : p_box_{Devs::_impl::Box<T>::create(value)} {}
     // always create unique
     Dynamic(const Dynamic& other) : p_box_{other.p_box_->copy()} {}
+    // moving hands over the box without copying the value
+    Dynamic(Dynamic&& other) noexcept = default;
 
   public: // methods
     template <typename T> T& ref() { return Devs::_impl::IBox::ref<T>(*p_box_); }
@@ -119,6 +367,355 @@ class Dynamic {
     std::unique_ptr<Devs::_impl::IBox> p_box_;
 };
 //----------------------------------------------------------------------------------------------------------------------
+namespace Traits {
+namespace _impl {
+template <typename S, typename = void> struct has_memory_usage : std::false_type {};
+template <typename S>
+struct has_memory_usage<S, std::void_t<decltype(std::declval<const S&>().memory_usage())>> : std::true_type {};
+
+template <typename S, typename = void> struct has_hash : std::false_type {};
+template <typename S> struct has_hash<S, std::void_t<decltype(std::declval<const S&>().hash())>> : std::true_type {};
+
+inline size_t string_heap_bytes(const std::string& string) {
+    // short strings live inside the object
+    static const auto sso_capacity = std::string{}.capacity();
+    return string.capacity() > sso_capacity ? string.capacity() + 1 : 0;
+}
+} // namespace _impl
+
+// FNV-1a, stable across runs and builds unlike std::hash
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+inline std::uint64_t fnv1a(const void* data, const size_t size, std::uint64_t hash = FNV_OFFSET) {
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T> std::uint64_t fnv1a(const T& value, const std::uint64_t hash = FNV_OFFSET) {
+    static_assert(std::is_trivially_copyable_v<T>, "fnv1a requires a trivially copyable value");
+    return fnv1a(std::addressof(value), sizeof(T), hash);
+}
+
+inline std::uint64_t fnv1a(const std::string& value, const std::uint64_t hash = FNV_OFFSET) {
+    return fnv1a(value.data(), value.size(), hash);
+}
+
+// splitmix64 finalizer, for combining hashes order-independently (xor of raw fnv values would cancel out too easily)
+inline std::uint64_t mix(std::uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+// bytes occupied by a model state
+// states owning heap memory should provide a size_t memory_usage() const method returning the bytes allocated
+// outside of the state object, or specialize this trait
+// an estimate is enough (e.g. element count or capacity times element size), it is evaluated after every transition
+// for the memory report of the printers and the state byte metrics
+template <typename S> struct StateSize {
+    static size_t bytes(const S& state) {
+        if constexpr (_impl::has_memory_usage<S>::value) {
+            return sizeof(S) + state.memory_usage();
+        } else {
+            (void)state;
+            return sizeof(S);
+        }
+    }
+};
+
+// stable (across runs and builds) hash of a model state
+// prefers a std::uint64_t hash() const method, then the object bytes of arithmetic and enum states, and falls back to
+// the printed state (printing is required for every state anyway)
+// the bytes of other types may hold addresses (pointers, handles) which differ between runs, so they are not hashed
+template <typename S> struct StateHash {
+    static std::uint64_t hash(const S& state) {
+        if constexpr (_impl::has_hash<S>::value) {
+            return state.hash();
+        } else if constexpr (std::is_arithmetic_v<S> || std::is_enum_v<S>) {
+            return fnv1a(state);
+        } else {
+            std::stringstream s;
+            s << std::setprecision(std::numeric_limits<double>::max_digits10) << state;
+            return fnv1a(s.str());
+        }
+    }
+};
+} // namespace Traits
+//----------------------------------------------------------------------------------------------------------------------
+namespace Timer {
+
+// hierarchical timing wheel of timeouts within a model state, e.g. one per waiting customer, the model derives its
+// time advance from next_timeout and advances the wheel by the elapsed times like the rest of its state
+// arming and cancelling take constant time, the earliest timer is cached and found by scanning one bucket
+template <typename T, typename Time = double> class Wheel {
+  public: // types
+    // identifies an armed timer, stale once the timer is popped or cancelled
+    struct Handle {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+  private: // types
+    struct Node {
+        T value;
+        Time deadline;
+        std::uint64_t tick;
+        std::uint32_t prev;
+        std::uint32_t next;
+        std::uint32_t generation;
+        std::uint32_t bucket;
+    };
+
+  public: // ctors, dtor
+    // timers within the same resolution tick share a bucket, choose it close to the typical timeout spacing
+    explicit Wheel(const Time resolution)
+        : resolution_{resolution}, now_{}, tick_{0}, nodes_{}, buckets_{}, occupied_{}, free_{NIL}, size_{0},
+          earliest_{NIL} {
+        if (!(Time{} < resolution)) {
+            throw std::runtime_error("Timer::Wheel requires a positive resolution");
+        }
+    }
+
+  public: // methods
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    size_t memory_usage() const {
+        return nodes_.capacity() * sizeof(Node) + buckets_.capacity() * sizeof(std::uint32_t);
+    }
+
+    bool armed(const Handle& handle) const {
+        return handle.index < nodes_.size() && nodes_[handle.index].generation == handle.generation &&
+               nodes_[handle.index].bucket != NIL;
+    }
+
+    Handle arm(const Time& timeout, const T& value) {
+        const auto deadline = now_ + std::max(timeout, Time{});
+        const auto tick = tick_of(deadline);
+        if (tick - tick_ >= std::uint64_t{1} << (SLOT_BITS * LEVELS)) {
+            throw std::runtime_error("Timer::Wheel timeout beyond the wheel horizon");
+        }
+        if (buckets_.empty()) {
+            buckets_.assign(SLOTS * LEVELS, NIL);
+        }
+        std::uint32_t idx = free_;
+        if (idx == NIL) {
+            idx = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.push_back({value, deadline, tick, NIL, NIL, 0, NIL});
+        } else {
+            free_ = nodes_[idx].next;
+            nodes_[idx].value = value;
+            nodes_[idx].deadline = deadline;
+            nodes_[idx].tick = tick;
+        }
+        link(idx);
+        ++size_;
+        if (earliest_ != NIL && deadline < nodes_[earliest_].deadline) {
+            earliest_ = idx;
+        }
+        return {idx, nodes_[idx].generation};
+    }
+
+    bool cancel(const Handle& handle) {
+        if (!armed(handle)) {
+            return false;
+        }
+        release(handle.index);
+        return true;
+    }
+
+    // time until the earliest deadline (zero when due), nothing when no timer is armed
+    std::optional<Time> next_timeout() const {
+        if (const auto idx = earliest(); idx != NIL) {
+            return std::max(nodes_[idx].deadline - now_, Time{});
+        }
+        return std::nullopt;
+    }
+
+    // value of the earliest timer, requires an armed timer
+    const T& next() const {
+        const auto idx = earliest();
+        if (idx == NIL) {
+            throw std::runtime_error("Timer::Wheel::next called without an armed timer");
+        }
+        return nodes_[idx].value;
+    }
+
+    // removes the earliest timer, e.g. once the time advance given by next_timeout elapsed
+    T pop() {
+        const auto idx = earliest();
+        if (idx == NIL) {
+            throw std::runtime_error("Timer::Wheel::pop called without an armed timer");
+        }
+        const auto value = nodes_[idx].value;
+        release(idx);
+        return value;
+    }
+
+    // moves the clock of the wheel, the timers due meanwhile stay armed until popped
+    void advance(const Time& elapsed) {
+        now_ += elapsed;
+        const auto target = tick_of(now_);
+        while (tick_ < target) {
+            const auto boundary = (tick_ | (SLOTS - 1)) + 1;
+            if (target < boundary || empty()) {
+                tick_ = target;
+                break;
+            }
+            // the overdue timers of the finished level 0 rotation move to the current slot, keeping the slot order
+            const auto overdue = unlink_bucket(0, 0, SLOTS);
+            if (upper_levels_empty()) {
+                tick_ = target;
+                relink(overdue);
+                break;
+            }
+            tick_ = boundary;
+            relink(overdue);
+            // cascade the slots the clock entered, from the highest level whose rotation advanced
+            size_t level = 1;
+            while (level + 1 < LEVELS && group(tick_, level) == 0) {
+                ++level;
+            }
+            for (; level > 0; --level) {
+                relink(unlink_bucket(level, group(tick_, level), group(tick_, level) + 1));
+            }
+        }
+    }
+
+  private: // static members
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr size_t LEVELS = 6;
+    static constexpr std::uint32_t NIL = std::numeric_limits<std::uint32_t>::max();
+
+  private: // static functions
+    static size_t group(const std::uint64_t tick, const size_t level) {
+        return static_cast<size_t>(tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+    }
+
+  private: // methods
+    std::uint64_t tick_of(const Time& time) const {
+        return static_cast<std::uint64_t>(std::floor(std::max(time, Time{}) / resolution_));
+    }
+
+    // timers of the current tick (or overdue ones) stay on level 0, the others on the level of the highest tick
+    // group differing from the clock
+    std::uint32_t bucket_of(const std::uint64_t tick) const {
+        if (tick <= tick_) {
+            return static_cast<std::uint32_t>(group(tick_, 0));
+        }
+        const auto highest_bit = static_cast<size_t>(63 - __builtin_clzll(tick ^ tick_));
+        const auto level = highest_bit / SLOT_BITS;
+        return static_cast<std::uint32_t>(level * SLOTS + group(tick, level));
+    }
+
+    bool upper_levels_empty() const {
+        return std::all_of(occupied_.begin() + 1, occupied_.end(), [](const std::uint64_t bits) { return bits == 0; });
+    }
+
+    void link(const std::uint32_t idx) {
+        auto& node = nodes_[idx];
+        node.bucket = bucket_of(node.tick);
+        node.prev = NIL;
+        node.next = buckets_[node.bucket];
+        if (node.next != NIL) {
+            nodes_[node.next].prev = idx;
+        }
+        buckets_[node.bucket] = idx;
+        occupied_[node.bucket / SLOTS] |= std::uint64_t{1} << (node.bucket % SLOTS);
+    }
+
+    void unlink(const std::uint32_t idx) {
+        auto& node = nodes_[idx];
+        if (node.prev != NIL) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            buckets_[node.bucket] = node.next;
+        }
+        if (node.next != NIL) {
+            nodes_[node.next].prev = node.prev;
+        }
+        if (buckets_[node.bucket] == NIL) {
+            occupied_[node.bucket / SLOTS] &= ~(std::uint64_t{1} << (node.bucket % SLOTS));
+        }
+        node.bucket = NIL;
+    }
+
+    // detaches the buckets [from, to) of the level as a single list
+    std::uint32_t unlink_bucket(const size_t level, const size_t from, const size_t to) {
+        std::uint32_t list = NIL;
+        for (size_t slot = from; slot < to; ++slot) {
+            auto& head = buckets_[level * SLOTS + slot];
+            while (head != NIL) {
+                const auto idx = head;
+                unlink(idx);
+                nodes_[idx].next = list;
+                list = idx;
+            }
+        }
+        return list;
+    }
+
+    void relink(std::uint32_t list) {
+        while (list != NIL) {
+            const auto idx = list;
+            list = nodes_[idx].next;
+            link(idx);
+        }
+    }
+
+    void release(const std::uint32_t idx) {
+        unlink(idx);
+        auto& node = nodes_[idx];
+        ++node.generation;
+        node.next = free_;
+        free_ = idx;
+        --size_;
+        if (earliest_ == idx) {
+            earliest_ = NIL;
+        }
+    }
+
+    // the lowest occupied slot of the lowest occupied level holds the earliest timer
+    std::uint32_t earliest() const {
+        if (earliest_ != NIL || size_ == 0) {
+            return earliest_;
+        }
+        for (size_t level = 0; level < LEVELS; ++level) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            const auto slot = static_cast<size_t>(__builtin_ctzll(occupied_[level]));
+            for (auto idx = buckets_[level * SLOTS + slot]; idx != NIL; idx = nodes_[idx].next) {
+                if (earliest_ == NIL || nodes_[idx].deadline < nodes_[earliest_].deadline) {
+                    earliest_ = idx;
+                }
+            }
+            break;
+        }
+        return earliest_;
+    }
+
+  private: // members
+    Time resolution_;
+    Time now_;
+    std::uint64_t tick_;
+    std::vector<Node> nodes_;
+    // head node of every slot of every level, allocated with the first timer
+    std::vector<std::uint32_t> buckets_;
+    std::array<std::uint64_t, LEVELS> occupied_;
+    std::uint32_t free_;
+    size_t size_;
+    mutable std::uint32_t earliest_;
+};
+} // namespace Timer
+//----------------------------------------------------------------------------------------------------------------------
 namespace Model {
 template <typename Time>
 using AbstractModelFactory =
@@ -140,11 +737,204 @@ template <typename X, typename Y, typename S, typename Time = double> struct Ato
     std::function<S(S)> delta_internal;
     std::function<Y(const S&)> out;
     std::function<Time(const S&)> ta;
+    // optional, time after which the trajectory without inputs starting with the (just entered) state returns to it,
+    // nothing when not periodic
+    // periodic models nobody observes (no output couplings or listeners, silent printer, no state hashes) skip their
+    // internal transitions until the next input or the end of the simulation, the skipped transitions are
+    // fast-forwarded by whole periods and replayed by delta_internal within the last one
+    std::function<std::optional<Time>(const S&)> period = {};
+};
+
+// finite-state deterministic atomic model, states and inputs are indices
+// tabulate evaluates the transition, output and time advance functions once for every state (and input) and returns
+// an atomic model whose transitions are lookups into the dense tables
+// an external transition either continues the remaining time advance of the state or restarts it from ta
+template <typename X, typename Y, typename Time = double> struct FiniteState {
+  public: // types
+    struct External {
+        size_t state;
+        bool continues;
+    };
+
+  private: // types
+    struct Table {
+        std::vector<std::uint32_t> internal;
+        // row per state, column per input
+        std::vector<External> external;
+        std::vector<Y> outputs;
+        std::vector<Time> time_advances;
+        std::vector<std::string> names;
+        size_t inputs;
+        std::function<size_t(const X&)> input_index;
+    };
+
+  public: // types
+    // discrete state index with the remaining time advance, trivially copyable
+    // the tables are owned by the functions of the tabulated model, a state is valid while they are
+    class State {
+      public: // friends
+        friend std::ostream& operator<<(std::ostream& os, const State& state) {
+            return os << "{ state = " << state.p_table_->names[state.index_] << ", remaining = " << state.remaining_
+                      << " }";
+        }
+
+      public: // ctors
+        State(const Table* p_table, const std::uint32_t index, const Time remaining)
+            : p_table_{p_table}, index_{index}, remaining_{remaining} {}
+
+      public: // methods
+        size_t index() const { return index_; }
+
+        const std::string& name() const { return p_table_->names[index_]; }
+
+        const Time& remaining() const { return remaining_; }
+
+        std::uint64_t hash() const {
+            return Devs::Traits::fnv1a(remaining_, Devs::Traits::fnv1a(static_cast<std::uint64_t>(index_)));
+        }
+
+      private: // members
+        const Table* p_table_;
+        std::uint32_t index_;
+        Time remaining_;
+    };
+
+  public: // methods
+    Atomic<X, Y, State, Time> tabulate() const {
+        if (states == 0 || initial >= states) {
+            throw std::runtime_error("FiniteState requires at least one state and a valid initial state");
+        }
+        if (states > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("FiniteState supports at most 2^32 - 1 states");
+        }
+        const auto check = [this](const size_t state, const char* function) {
+            if (state >= states) {
+                throw std::runtime_error(std::string{"FiniteState "} + function +
+                                         " returned an invalid state: " + std::to_string(state));
+            }
+            return state;
+        };
+
+        auto p_table = std::make_shared<Table>();
+        p_table->inputs = inputs;
+        p_table->input_index = input_index;
+        p_table->internal.reserve(states);
+        p_table->external.reserve(states * inputs);
+        p_table->outputs.reserve(states);
+        p_table->time_advances.reserve(states);
+        p_table->names.reserve(states);
+        for (size_t state = 0; state < states; ++state) {
+            p_table->internal.push_back(static_cast<std::uint32_t>(check(delta_internal(state), "delta_internal")));
+            for (size_t input = 0; input < inputs; ++input) {
+                const auto next = delta_external(state, input);
+                p_table->external.push_back({check(next.state, "delta_external"), next.continues});
+            }
+            p_table->outputs.push_back(out(state));
+            p_table->time_advances.push_back(ta(state));
+            p_table->names.push_back(name ? name(state) : std::to_string(state));
+        }
+
+        static_assert(std::is_trivially_copyable_v<State> || !std::is_trivially_copyable_v<Time>);
+        return {
+            State{p_table.get(), static_cast<std::uint32_t>(initial), p_table->time_advances[initial]},
+            [p_table](State s, const Time& elapsed, const X& x) {
+                const auto input = p_table->input_index(x);
+                if (input >= p_table->inputs) {
+                    throw std::runtime_error("FiniteState input_index returned an invalid input: " +
+                                             std::to_string(input));
+                }
+                const auto& next = p_table->external[s.index() * p_table->inputs + input];
+                const auto remaining = next.continues ? s.remaining() - elapsed : p_table->time_advances[next.state];
+                return State{p_table.get(), static_cast<std::uint32_t>(next.state), remaining};
+            },
+            [p_table](State s) {
+                const auto next = p_table->internal[s.index()];
+                return State{p_table.get(), next, p_table->time_advances[next]};
+            },
+            [p_table](const State& s) { return p_table->outputs[s.index()]; },
+            [](const State& s) { return s.remaining(); },
+        };
+    }
+
+    operator AbstractModelFactory<Time>() const { return tabulate(); }
+
+  public: // members
+    size_t states;
+    size_t inputs;
+    size_t initial;
+    std::function<size_t(const X&)> input_index;
+    std::function<size_t(size_t)> delta_internal;
+    std::function<External(size_t, size_t)> delta_external;
+    std::function<Y(size_t)> out;
+    std::function<Time(size_t)> ta;
+    // printed state names, defaults to the index
+    std::function<std::string(size_t)> name = {};
 };
 
 using Transformer = std::optional<std::function<Dynamic(const Dynamic&)>>;
 using Influencers = std::unordered_map<std::optional<std::string>, Transformer>;
 
+template <typename Time = double> struct Input {
+  public: // members
+    Time time;
+    Dynamic value;
+};
+
+// an output of a model delivered in a batch, see IOModel::add_batch_output_listener
+template <typename Time = double> struct Output {
+  public: // members
+    Time time;
+    Dynamic value;
+};
+
+// lazily evaluated external inputs in non-decreasing time order, returns nothing when exhausted
+// the calendar only holds the next input of a source, its state is part of the simulator checkpoints
+template <typename Time = double> using InputSource = std::function<std::optional<Input<Time>>()>;
+
+// delivers a generated value at every generated arrival time up to the end time (e.g. Random arrival generators)
+template <typename Time = double>
+InputSource<Time> arrival_source(std::function<Time()> arrivals, const Time end, std::function<Dynamic()> value) {
+    return [arrivals, end, value]() mutable -> std::optional<Input<Time>> {
+        const auto time = arrivals();
+        if (time > end) {
+            return std::nullopt;
+        }
+        return Input<Time>{time, value()};
+    };
+}
+
+// changes the parameters kept in the state of an atomic model during a run (e.g. the staffing of a queue), receives
+// the state and the time elapsed since the last transition like delta_external
+template <typename S, typename Time = double> using ParameterUpdate = std::function<S(S, const Time&)>;
+
+// parameter updates of components (atomic models named uniquely within the simulated model) at given times, applied
+// by dedicated events without rebuilding the model or coupling extra inputs, see Simulator::set_parameter_schedule
+template <typename Time = double> class ParameterSchedule {
+  public: // types
+    struct Change {
+        Time time;
+        std::string component;
+        Dynamic update;
+        std::string description;
+    };
+
+  public: // ctors, dtor
+    ParameterSchedule() : changes_{} {}
+
+  public: // methods
+    template <typename S>
+    ParameterSchedule& at(const Time time, const std::string component, const ParameterUpdate<S, Time> update,
+                          const std::string description = "parameter update") {
+        changes_.push_back(Change{time, component, update, description});
+        return *this;
+    }
+
+    const std::vector<Change>& changes() const { return changes_; }
+
+  private: // members
+    std::vector<Change> changes_;
+};
+
 template <typename Time = double> struct Compound {
   public: // static functions
     static std::string fifo_selector(const std::vector<std::string>& names) {
@@ -167,22 +957,99 @@ template <typename Time = double> struct Compound {
     std::function<std::string(const std::vector<std::string>&)> select = fifo_selector;
 };
 } // namespace Model
+
+// pending event structures of the calendar
+enum class EventSetKind : int { BINARY_HEAP, CALENDAR_QUEUE };
+
+inline std::string event_set_kind_to_str(const EventSetKind kind) {
+    switch (kind) {
+    case EventSetKind::BINARY_HEAP:
+        return "binary_heap";
+    case EventSetKind::CALENDAR_QUEUE:
+        return "calendar_queue";
+    default:
+        throw std::runtime_error("Unhandled EventSetKind value in event_set_kind_to_str");
+    }
+}
 //----------------------------------------------------------------------------------------------------------------------
 namespace _impl {
 // aliases
-using Action = std::function<void()>;
 template <typename... Args> using Listener = std::function<void(Args...)>;
 template <typename... Args> using Listeners = std::vector<Listener<Args...>>;
 
+// events are executed by a switch over the kind in IOModel::dispatch instead of type-erased closures
+// the internal transitions live in the transition slots of the calendar, their events only serve the printers
+enum class EventKind : int {
+    INTERNAL_TRANSITION,
+    INFLUENCER_INPUT,
+    EXTERNAL_INPUT,
+    SOURCE_INPUT,
+    PARTITION_INPUT,
+    PARAMETER_UPDATE
+};
+
+// data of an input event, kept in the payload pool of the calendar until the event is dispatched
+struct EventPayload {
+  public: // members
+    Dynamic value;
+    // influencer inputs, interned by the calendar
+    const std::string* p_from;
+    // input source or partition of source and partition inputs
+    size_t index;
+};
+
+// slab of the payloads of the pending input events, a slot is reused once its event has been dispatched
+class EventPayloads {
+  public: // methods
+    std::uint32_t acquire(EventPayload payload) {
+        if (free_.empty()) {
+            slots_.emplace_back(std::move(payload));
+            return static_cast<std::uint32_t>(slots_.size() - 1);
+        }
+        const auto handle = free_.back();
+        free_.pop_back();
+        slots_[handle].emplace(std::move(payload));
+        return handle;
+    }
+
+    const EventPayload& operator[](const std::uint32_t handle) const { return *slots_[handle]; }
+
+    // moves the payload out and frees its slot, the events scheduled while dispatching may reuse it
+    EventPayload release(const std::uint32_t handle) {
+        EventPayload payload{std::move(*slots_[handle])};
+        slots_[handle].reset();
+        free_.push_back(handle);
+        return payload;
+    }
+
+    void clear() {
+        slots_.clear();
+        free_.clear();
+    }
+
+    size_t memory_usage() const {
+        return slots_.capacity() * sizeof(std::optional<EventPayload>) + free_.capacity() * sizeof(std::uint32_t);
+    }
+
+  private: // members
+    std::vector<std::optional<EventPayload>> slots_{};
+    std::vector<std::uint32_t> free_{};
+};
+
+// a pending event is a record of the kind, the target and the handle of its payload, the descriptions are interned
 template <typename Time> class Event {
 
+  public: // static members
+    static constexpr std::uint32_t NO_PAYLOAD = std::numeric_limits<std::uint32_t>::max();
+
   public: // ctors, dtor
-    explicit Event(const Time time, const Action action, const std::string model, const std::string description = "")
-        : time_{time}, action_{action}, model_{model}, description_{description},
-          cancelled_{std::make_shared<bool>(false)} {}
+    explicit Event(const Time time, const EventKind kind, IOModel<Time>* p_target,
+                   const std::uint32_t payload = NO_PAYLOAD, const std::string* p_description = nullptr)
+        : time_{time}, scheduled_{}, sequence_{0}, p_target_{p_target}, p_description_{p_description}, kind_{kind},
+          payload_{payload} {}
 
   public: // methods
-    std::string to_string(const bool with_description = true, const bool with_cancelled = false) const {
+    std::string to_string(const bool with_description = true) const {
         std::stringstream s;
         s << "Event{ time = " << time();
 
@@ -191,77 +1058,520 @@ template <typename Time> class Event {
         if (with_description) {
             s << ", description = " << description();
         }
-
-        if (with_cancelled) {
-            s << std::boolalpha; // write boolean as true/false
-            s << ", cancelled = " << is_cancelled();
-        }
         s << " }";
         return s.str();
     }
 
-    const std::string& description() const { return description_; }
-
-    bool is_cancelled() const { return *cancelled_; }
-
-    std::function<void()> get_cancel_callback() const {
-        // allow cancelling "remotely", as there is no sensible way to traverse a std::priority_queue
-        // use a shared pointer for proper cancelling even if the object is moved around
-        auto copy = cancelled_;
-        return [copy]() { *copy = true; };
+    const std::string& description() const {
+        static const std::string internal_transition{"internal transition"};
+        static const std::string influencer_input{"influencer input"};
+        switch (kind_) {
+        case EventKind::INTERNAL_TRANSITION:
+            return internal_transition;
+        case EventKind::INFLUENCER_INPUT:
+            return influencer_input;
+        default:
+            return *p_description_;
+        }
     }
 
     const Time& time() const { return time_; }
 
-    void action() const { action_(); }
+    const std::string& model() const { return p_target_->name(); }
+
+    // executing the event changes the target model
+    IOModel<Time>& target() const { return *p_target_; }
+
+    EventKind kind() const { return kind_; }
+
+    // handle into the payload pool of the calendar, the internal transition events carry no payload
+    std::uint32_t payload() const { return payload_; }
+
+    // scheduling order, assigned by the calendar
+    std::uint64_t sequence() const { return sequence_; }
+    void set_sequence(const std::uint64_t sequence) { sequence_ = sequence; }
+
+    // calendar time at scheduling, orders an input against the internal transitions skipped by its target
+    const Time& scheduled() const { return scheduled_; }
+    void set_scheduled(const Time& scheduled) { scheduled_ = scheduled; }
+
+    // the payload moves into another slot when the event is restored from a checkpoint
+    void set_payload(const std::uint32_t payload) { payload_ = payload; }
 
-    const std::string& model() const { return model_; }
+    // estimate, including the pooled payload
+    size_t memory_usage() const {
+        return payload_ == NO_PAYLOAD ? sizeof(Event<Time>) : sizeof(Event<Time>) + sizeof(EventPayload);
+    }
 
   private: // members
     Time time_;
-    Action action_;
-    std::string model_;
-    std::string description_;
-    std::shared_ptr<bool> cancelled_;
+    Time scheduled_;
+    std::uint64_t sequence_;
+    IOModel<Time>* p_target_;
+    const std::string* p_description_;
+    EventKind kind_;
+    std::uint32_t payload_;
 };
 
 template <typename Time> class EventSorter {
   public:
     // a sooner event should get priority, FIFO otherwise
-    bool operator()(const Event<Time>& l, const Event<Time>& r) { return l.time() > r.time(); }
+    bool operator()(const Event<Time>& l, const Event<Time>& r) const {
+        return l.time() > r.time() || (!(r.time() > l.time()) && l.sequence() > r.sequence());
+    }
 };
 
+// probe arguments have to be integers or pointers, the time is passed in millionths of the time unit
+template <typename Time> std::int64_t probe_time(const Time& time) {
+    constexpr double scale = 1e6;
+    const auto scaled = static_cast<double>(time) * scale;
+    if (!(std::abs(scaled) < static_cast<double>(std::numeric_limits<std::int64_t>::max()))) {
+        return scaled < 0 ? std::numeric_limits<std::int64_t>::min() : std::numeric_limits<std::int64_t>::max();
+    }
+    return static_cast<std::int64_t>(scaled);
+}
+
+// translates a failed dynamic cast into a descriptive error
+template <typename F, typename M> decltype(auto) checked_cast(F f, M message) {
+    try {
+        return f();
+    } catch (const std::bad_cast&) {
+        throw std::runtime_error(message());
+    }
+}
+
 template <typename... Args> void invoke_listeners(const Listeners<Args...> listeners, Args... args) {
     for (const auto listener : listeners) {
         listener(args...);
     }
 }
 
-template <typename Time>
-using CalendarBase = std::priority_queue<Event<Time>, std::vector<Event<Time>>, EventSorter<Time>>;
+// an in-process checkpoint, either full or incremental (containing only what changed since the previous one)
+// events hold closures bound to the live models, thus checkpoints can only be restored into the same simulator
+template <typename Time> struct Checkpoint {
+  public: // members
+    bool full;
+    Time time;
+    std::uint64_t step;
+    std::uint64_t executed_events;
+    std::uint64_t next_sequence;
+    // atomic model snapshots keyed by the model, only the models that transitioned for incremental checkpoints
+    std::unordered_map<const IOModel<Time>*, Dynamic> states;
+    // pending input events with copies of their payloads, internal transitions are restored from the model snapshots
+    // a full checkpoint lists every pending input event, an incremental one the scheduled and removed events
+    std::vector<std::pair<Event<Time>, EventPayload>> scheduled_events;
+    std::vector<std::uint64_t> removed_events;
+    // external input sources keyed by the model and source index, only the advanced ones for incremental checkpoints
+    std::map<std::pair<const IOModel<Time>*, size_t>, Devs::Model::InputSource<Time>> sources;
+};
+
+// pending events in EventSorter order, kept either in a binary heap or in a calendar queue (Brown, 1988)
+// both structures yield the exact same order, so the calendar can migrate between them at any time
+template <typename Time> class EventSet {
+  public: // ctors, dtor
+    explicit EventSet(const EventSetKind kind = EventSetKind::BINARY_HEAP) : kind_{kind} {
+        if (kind_ == EventSetKind::CALENDAR_QUEUE) {
+            rebuild(MIN_BUCKETS, {});
+        }
+    }
+
+  public: // methods
+    EventSetKind kind() const { return kind_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void push(const Event<Time>& event) {
+        ++size_;
+        if (kind_ == EventSetKind::BINARY_HEAP) {
+            heap_.push_back(event);
+            std::push_heap(heap_.begin(), heap_.end(), EventSorter<Time>{});
+            return;
+        }
+        insert(event);
+        if (bucket_events_ > 2 * bucket_count()) {
+            rebuild(2 * bucket_count(), drain());
+        }
+    }
+
+    const Event<Time>& top() {
+        if (kind_ == EventSetKind::BINARY_HEAP) {
+            return heap_.front();
+        }
+        return bucket_min(locate_min());
+    }
+
+    void pop() {
+        --size_;
+        if (kind_ == EventSetKind::BINARY_HEAP) {
+            std::pop_heap(heap_.begin(), heap_.end(), EventSorter<Time>{});
+            heap_.pop_back();
+            return;
+        }
+        const auto idx = locate_min();
+        min_bucket_.reset();
+        if (idx == far_bucket()) {
+            std::pop_heap(buckets_[idx].begin(), buckets_[idx].end(), EventSorter<Time>{});
+            buckets_[idx].pop_back();
+            return;
+        }
+        buckets_[idx].pop_back();
+        --bucket_events_;
+        if (bucket_count() > MIN_BUCKETS && 2 * bucket_events_ < bucket_count()) {
+            rebuild(bucket_count() / 2, drain());
+        }
+    }
+
+    void clear() {
+        heap_.clear();
+        size_ = 0;
+        if (kind_ == EventSetKind::CALENDAR_QUEUE) {
+            rebuild(MIN_BUCKETS, {});
+        }
+    }
+
+    template <typename F> void for_each(F f) const {
+        for (const auto& event : heap_) {
+            f(event);
+        }
+        for (const auto& bucket : buckets_) {
+            for (const auto& event : bucket) {
+                f(event);
+            }
+        }
+    }
+
+    // the next (at most) limit pending events, in execution order
+    std::vector<const Event<Time>*> peek(const size_t limit) const {
+        if (kind_ == EventSetKind::BINARY_HEAP) {
+            std::vector<const Event<Time>*> events{};
+            peek_heap(heap_, limit, events);
+            return events;
+        }
+        return peek_buckets(limit);
+    }
+
+    // moves every pending event into the other structure, O(n)
+    void migrate(const EventSetKind kind) {
+        if (kind == kind_) {
+            return;
+        }
+        if (kind == EventSetKind::BINARY_HEAP) {
+            auto events = drain();
+            buckets_.clear();
+            heap_ = std::move(events);
+            std::make_heap(heap_.begin(), heap_.end(), EventSorter<Time>{});
+        } else {
+            auto events = std::move(heap_);
+            heap_.clear();
+            size_t buckets = MIN_BUCKETS;
+            while (buckets < events.size()) {
+                buckets *= 2;
+            }
+            rebuild(buckets, std::move(events));
+        }
+        kind_ = kind;
+    }
+
+  private: // static members
+    // a power of two, bucket indices are masked virtual bucket numbers
+    static constexpr size_t MIN_BUCKETS = 16;
+    // events sampled for estimating the bucket width
+    static constexpr size_t WIDTH_SAMPLE = 25;
+    // virtual bucket numbers have to stay exact in a double
+    static constexpr double HORIZON_BUCKETS = 4503599627370496.0; // 2^52
+
+  private: // static functions
+    static void peek_heap(const std::vector<Event<Time>>& heap, const size_t limit,
+                          std::vector<const Event<Time>*>& events) {
+        // best-first search over the heap, O(limit * log(limit)) regardless of the heap size
+        const auto later = [&heap](const size_t l, const size_t r) { return EventSorter<Time>{}(heap[l], heap[r]); };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(later)> frontier{later};
+        if (!heap.empty()) {
+            frontier.push(0);
+        }
+        while (!frontier.empty() && events.size() < limit) {
+            const auto idx = frontier.top();
+            frontier.pop();
+            events.push_back(std::addressof(heap[idx]));
+            for (const auto child : {2 * idx + 1, 2 * idx + 2}) {
+                if (child < heap.size()) {
+                    frontier.push(child);
+                }
+            }
+        }
+    }
+
+  private: // methods
+    size_t bucket_count() const { return static_cast<size_t>(mask_) + 1; }
+
+    // an extra last bucket is a heap of the events beyond the horizon (e.g. the infinite times of passive models)
+    size_t far_bucket() const { return bucket_count(); }
+
+    const Event<Time>& bucket_min(const size_t idx) const {
+        return idx == far_bucket() ? buckets_[idx].front() : buckets_[idx].back();
+    }
+
+    bool beyond_horizon(const Time& time) const { return !(static_cast<double>(time) < horizon_); }
+
+    std::int64_t virtual_bucket(const Time& time) const {
+        return static_cast<std::int64_t>(std::floor(static_cast<double>(time) / width_));
+    }
+
+    size_t bucket_index(const std::int64_t virtual_bucket) const {
+        return static_cast<size_t>(static_cast<std::uint64_t>(virtual_bucket) & mask_);
+    }
+
+    void insert(const Event<Time>& event) {
+        if (beyond_horizon(event.time())) {
+            auto& far = buckets_[far_bucket()];
+            far.push_back(event);
+            std::push_heap(far.begin(), far.end(), EventSorter<Time>{});
+            if (min_bucket_ == far_bucket()) {
+                min_bucket_.reset();
+            }
+            return;
+        }
+        const auto virtual_bucket_number = virtual_bucket(event.time());
+        if (bucket_events_ == 0 || virtual_bucket_number < current_) {
+            current_ = virtual_bucket_number;
+        }
+        // buckets are sorted from the latest to the earliest event
+        auto& bucket = buckets_[bucket_index(virtual_bucket_number)];
+        if (min_bucket_ && (*min_bucket_ == far_bucket() || EventSorter<Time>{}(bucket_min(*min_bucket_), event))) {
+            min_bucket_.reset();
+        }
+        bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), event, EventSorter<Time>{}), event);
+        ++bucket_events_;
+    }
+
+    // index of the bucket holding the earliest event, the set must not be empty
+    size_t locate_min() {
+        if (min_bucket_) {
+            return *min_bucket_;
+        }
+        if (bucket_events_ == 0) {
+            min_bucket_ = far_bucket();
+            return far_bucket();
+        }
+        // scan one year of buckets starting at the current one
+        for (size_t i = 0; i <= mask_; ++i) {
+            const auto idx = bucket_index(current_);
+            const auto& bucket = buckets_[idx];
+            if (!bucket.empty() && virtual_bucket(bucket.back().time()) == current_) {
+                min_bucket_ = idx;
+                return idx;
+            }
+            ++current_;
+        }
+        // sparse calendar, search the earliest event directly
+        size_t min_idx = 0;
+        for (size_t idx = 0; idx <= mask_; ++idx) {
+            const auto& bucket = buckets_[idx];
+            if (!bucket.empty() &&
+                (buckets_[min_idx].empty() || EventSorter<Time>{}(buckets_[min_idx].back(), bucket.back()))) {
+                min_idx = idx;
+            }
+        }
+        current_ = virtual_bucket(buckets_[min_idx].back().time());
+        min_bucket_ = min_idx;
+        return min_idx;
+    }
+
+    std::vector<Event<Time>> drain() {
+        std::vector<Event<Time>> events{};
+        events.reserve(size_);
+        for (auto& bucket : buckets_) {
+            std::move(bucket.begin(), bucket.end(), std::back_inserter(events));
+        }
+        return events;
+    }
+
+    // bucket width of three average separations of the earliest events (Brown's estimate)
+    double estimate_width(const std::vector<Event<Time>>& events) const {
+        std::vector<double> times{};
+        for (const auto& event : events) {
+            const auto time = static_cast<double>(event.time());
+            if (std::isfinite(time)) {
+                times.push_back(time);
+            }
+        }
+        const auto sample = std::min(times.size(), WIDTH_SAMPLE);
+        if (sample < 2) {
+            return width_;
+        }
+        std::partial_sort(times.begin(), times.begin() + sample, times.end());
+        const auto separation = (times[sample - 1] - times[0]) / static_cast<double>(sample - 1);
+        if (!(separation > 0.0)) {
+            return width_;
+        }
+        return 3.0 * separation;
+    }
+
+    void rebuild(const size_t buckets, std::vector<Event<Time>> events) {
+        width_ = estimate_width(events);
+        horizon_ = width_ * HORIZON_BUCKETS;
+        mask_ = buckets - 1;
+        buckets_.assign(buckets + 1, {});
+        bucket_events_ = 0;
+        current_ = 0;
+        min_bucket_.reset();
+        for (const auto& event : events) {
+            insert(event);
+        }
+    }
+
+    std::vector<const Event<Time>*> peek_buckets(const size_t limit) const {
+        std::vector<const Event<Time>*> events{};
+        // walk one year of buckets in order, each bucket holds its events of the current year at its end
+        size_t visited{};
+        auto virtual_bucket_number = current_;
+        for (size_t i = 0; i <= mask_ && events.size() < limit && bucket_events_ > 0; ++i, ++virtual_bucket_number) {
+            const auto& bucket = buckets_[bucket_index(virtual_bucket_number)];
+            for (auto it = bucket.rbegin();
+                 it != bucket.rend() && virtual_bucket(it->time()) == virtual_bucket_number && events.size() < limit;
+                 ++it) {
+                ++visited;
+                events.push_back(std::addressof(*it));
+            }
+        }
+        if (events.size() < limit && visited < bucket_events_) {
+            // the remaining bucket events lie beyond one year
+            std::vector<const Event<Time>*> later{};
+            for (size_t idx = 0; idx <= mask_; ++idx) {
+                for (const auto& event : buckets_[idx]) {
+                    if (virtual_bucket(event.time()) >= virtual_bucket_number) {
+                        later.push_back(std::addressof(event));
+                    }
+                }
+            }
+            const auto count = std::min(limit - events.size(), later.size());
+            std::partial_sort(later.begin(), later.begin() + count, later.end(),
+                              [](const auto l, const auto r) { return EventSorter<Time>{}(*r, *l); });
+            events.insert(events.end(), later.begin(), later.begin() + count);
+        }
+        peek_heap(buckets_[far_bucket()], limit, events);
+        return events;
+    }
+
+  private: // members
+    EventSetKind kind_;
+    size_t size_{};
+    std::vector<Event<Time>> heap_{};
+    // calendar queue
+    std::vector<std::vector<Event<Time>>> buckets_{};
+    size_t bucket_events_{};
+    double width_{1.0};
+    double horizon_{HORIZON_BUCKETS};
+    std::uint64_t mask_{};
+    std::int64_t current_{};
+    std::optional<size_t> min_bucket_{};
+};
+
+// winner tree over a flat array of (time, sequence) keys in EventSorter order, the root holds the earliest leaf
+// updating a key replays its path to the root, O(log n) without allocating or leaving stale entries behind
+template <typename Time> class TournamentTree {
+  public: // types
+    struct Key {
+        Time time;
+        std::uint64_t sequence;
+    };
+
+  public: // static members
+    // time of the unused leaves, later than any scheduled time
+    static constexpr Time NEVER = std::numeric_limits<Time>::has_infinity ? std::numeric_limits<Time>::infinity()
+                                                                         : std::numeric_limits<Time>::max();
+
+  public: // methods
+    size_t size() const { return size_; }
+
+    // leaves holding a key before NEVER
+    size_t scheduled() const { return scheduled_; }
 
-template <typename Time> class Calendar : private CalendarBase<Time> {
+    size_t memory_usage() const { return keys_.capacity() * sizeof(Key) + winners_.capacity() * sizeof(size_t); }
+
+    const Key& key(const size_t leaf) const { return keys_[leaf]; }
+
+    // leaf holding the earliest key, the tree must not be empty
+    size_t top() const { return winners_[1]; }
+
+    // appends a leaf, returning its index
+    size_t add(const Key& key) {
+        if (size_ == capacity()) {
+            grow();
+        }
+        const auto leaf = size_++;
+        update(leaf, key);
+        return leaf;
+    }
+
+    void update(const size_t leaf, const Key& key) {
+        scheduled_ -= keys_[leaf].time < NEVER ? 1 : 0;
+        scheduled_ += key.time < NEVER ? 1 : 0;
+        keys_[leaf] = key;
+        for (auto node = (capacity() + leaf) / 2; node > 0; node /= 2) {
+            winners_[node] = earlier(winners_[2 * node], winners_[2 * node + 1]);
+        }
+    }
+
+  private: // methods
+    size_t capacity() const { return keys_.size(); }
+
+    size_t earlier(const size_t l, const size_t r) const {
+        const auto& lk = keys_[l];
+        const auto& rk = keys_[r];
+        return lk.time < rk.time || (!(rk.time < lk.time) && lk.sequence < rk.sequence) ? l : r;
+    }
+
+    // doubles the leaves, the nodes are rebuilt bottom-up in O(n)
+    void grow() {
+        const auto leaves = std::max<size_t>(1, 2 * capacity());
+        keys_.resize(leaves, Key{NEVER, std::numeric_limits<std::uint64_t>::max()});
+        winners_.assign(2 * leaves, 0);
+        for (size_t leaf = 0; leaf < leaves; ++leaf) {
+            winners_[leaves + leaf] = leaf;
+        }
+        for (auto node = leaves - 1; node > 0; --node) {
+            winners_[node] = earlier(winners_[2 * node], winners_[2 * node + 1]);
+        }
+    }
+
+  private: // members
+    size_t size_{};
+    size_t scheduled_{};
+    std::vector<Key> keys_{};
+    // implicit binary tree rooted at 1, the last level maps the leaves to themselves
+    std::vector<size_t> winners_{};
+};
+
+template <typename Time> class Calendar {
 
   public: // ctors, dtor
     explicit Calendar(const Time start_time, const Time end_time, const Time epsilon)
-        : CalendarBase<Time>{EventSorter<Time>{}}, time_{start_time}, end_time_{end_time}, epsilon_{epsilon},
-          time_advanced_listeners_{}, event_scheduled_listeners_{}, executing_event_action_listeners_{} {}
+        : events_{}, payloads_{}, names_{}, time_{start_time}, end_time_{end_time}, epsilon_{epsilon},
+          executed_events_{0}, bytes_{0}, peak_bytes_{0}, next_sequence_{0}, tracking_{false}, scheduled_log_{},
+          removed_log_{}, transitions_{}, slots_{}, time_advanced_listeners_{}, event_scheduled_listeners_{},
+          executing_event_action_listeners_{} {}
 
   public: // methods
     const Time& time() const { return time_; }
     const Time& end_time() const { return end_time_; }
-
-    std::string to_string() const {
-        // create queue copy as items are deleted when traversing
-        auto copy = *this;
+    // events closer in time are concurrent
+    const Time& epsilon() const { return epsilon_; }
+    std::uint64_t executed_events() const { return executed_events_; }
+    // the slots of passive models (internal transition at infinity) hold no pending event
+    size_t pending_events() const { return events_.size() + transitions_.scheduled(); }
+    // estimated memory held by the pending events
+    size_t memory_usage() const { return bytes_ + slots_memory_usage(); }
+    size_t peak_memory_usage() const { return peak_bytes_ + slots_memory_usage(); }
+
+    std::string to_string(const size_t limit = std::numeric_limits<size_t>::max()) const {
+        const auto events = peek(limit);
 
         std::stringstream s;
         s << "|";
-        for (; !copy.empty(); copy.pop()) {
-
-            const auto event = copy.top();
-            s << event.to_string();
-            if (copy.size() > 1) {
+        for (size_t i = 0; i < events.size(); ++i) {
+            s << events[i].to_string();
+            if (i < events.size() - 1) {
                 s << " | ";
             }
         }
@@ -269,29 +1579,154 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
         return s.str();
     }
 
-    void schedule_event(const Event<Time> event) {
-        if (event.time() < time()) {
+    // the next (at most) limit pending events in execution order, without modifying the calendar
+    // the internal transitions are materialized as events, which costs O(models) on top of the input events
+    std::vector<Event<Time>> peek(const size_t limit) const {
+        std::vector<Event<Time>> events{};
+        for (const auto p_event : events_.peek(limit)) {
+            events.push_back(*p_event);
+        }
+        std::vector<size_t> slots(transitions_.size());
+        std::iota(slots.begin(), slots.end(), 0);
+        const auto count = std::min(limit, slots.size());
+        const auto earlier = [this](const size_t l, const size_t r) {
+            const auto& lk = transitions_.key(l);
+            const auto& rk = transitions_.key(r);
+            return lk.time < rk.time || (!(rk.time < lk.time) && lk.sequence < rk.sequence);
+        };
+        std::partial_sort(slots.begin(), slots.begin() + count, slots.end(), earlier);
+        for (size_t i = 0; i < count; ++i) {
+            events.push_back(transition_event(slots[i]));
+        }
+        std::sort(events.begin(), events.end(), [](const auto& l, const auto& r) { return EventSorter<Time>{}(r, l); });
+        events.erase(events.begin() + static_cast<std::ptrdiff_t>(std::min(limit, events.size())), events.end());
+        return events;
+    }
+
+    EventSetKind event_set_kind() const { return events_.kind(); }
+    std::uint64_t event_set_migrations() const { return migrations_; }
+    // moving average of the time between scheduling and the scheduled (finite) time of the events
+    double hold_time_mean() const { return hold_mean_; }
+
+    // use the given pending event structure, optionally letting the cost model migrate it afterwards
+    void set_event_set(const EventSetKind kind, const bool adaptive) {
+        if (kind != events_.kind()) {
+            events_.migrate(kind);
+            ++migrations_;
+        }
+        adaptive_ = adaptive;
+    }
+
+    // the payload is pooled until the event is dispatched, the description has to be interned (see intern)
+    void schedule_input(const Time& time, const EventKind kind, IOModel<Time>* p_target, EventPayload payload,
+                        const std::string* p_description = nullptr) {
+#if DEVS_CHECKED
+        if (time < time_) {
             std::stringstream s;
-            s << "Attempted to schedule an event (" << event.to_string() << ") in the past (current time: " << time()
-              << ")";
+            s << "Attempted to schedule an event ("
+              << Event<Time>{time, kind, p_target, Event<Time>::NO_PAYLOAD, p_description}.to_string()
+              << ") in the past (current time: " << time_ << ")";
             throw std::runtime_error(s.str());
         }
+#endif
+        Event<Time> event{time, kind, p_target, payloads_.acquire(std::move(payload)), p_description};
+        event.set_sequence(next_sequence_++);
+        event.set_scheduled(time_);
+        DEVS_PROBE4(event__schedule, probe_time(event.time()), event.model().c_str(), static_cast<int>(event.kind()),
+                    event.sequence());
+        push_event(event);
+        if (trace_events_) {
+            invoke_listeners<const Time&, const Event<Time>&>(event_scheduled_listeners_, time_, event);
+        }
+    }
+
+    // names and descriptions of the input events, stored once for the lifetime of the calendar
+    const std::string* intern(const std::string& name) {
+        // looked up first, inserting would copy the name even when present
+        const auto it = names_.find(name);
+        return std::addressof(it != names_.end() ? *it : *names_.insert(name).first);
+    }
+
+    // atomic models own a slot holding their single pending internal transition, executed by the model when due
+    size_t add_transition_slot(IOModel<Time>* p_model) {
+        slots_.push_back({p_model});
+        return transitions_.add({TournamentTree<Time>::NEVER, std::numeric_limits<std::uint64_t>::max()});
+    }
+
+    // moves the internal transition of the slot in place, which replaces (cancels) the previous one
+    void schedule_transition(const size_t slot, const Time& time) {
+#if DEVS_CHECKED
+        if (time < time_) {
+            std::stringstream s;
+            s << "Attempted to schedule an internal transition of model " << slots_[slot].p_model->name() << " at "
+              << time << " in the past (current time: " << time_ << ")";
+            throw std::runtime_error(s.str());
+        }
+#endif
+        const auto sequence = next_sequence_++;
+        DEVS_PROBE4(event__schedule, probe_time(time), slots_[slot].p_model->name().c_str(),
+                    static_cast<int>(EventKind::INTERNAL_TRANSITION), sequence);
+        transitions_.update(slot, {time, sequence});
+        if (trace_events_ && !event_scheduled_listeners_.empty()) {
+            invoke_listeners<const Time&, const Event<Time>&>(event_scheduled_listeners_, time_,
+                                                              transition_event(slot));
+        }
+    }
+
+    // an external transition left the next internal transition time unchanged, no rescheduling was needed
+    void count_kept_transition() { ++kept_transitions_; }
+    std::uint64_t kept_transitions() const { return kept_transitions_; }
+    // an external transition moved the next internal transition, replacing the one in the slot
+    void count_rescheduled_transition() { ++rescheduled_transitions_; }
+    std::uint64_t rescheduled_transitions() const { return rescheduled_transitions_; }
+
+    // the event listeners need events to be materialized for the internal transitions, disable when unused
+    void set_event_tracing(const bool trace) { trace_events_ = trace; }
+
+    // periodic atomic models skip their internal transitions while the transitions are not traced, they resume once
+    // the tracing is enabled (e.g. by a verbose replay)
+    bool traces_transitions() const { return trace_transitions_; }
+    void set_transition_tracing(const bool trace) {
+        const auto resume = trace && !trace_transitions_;
+        trace_transitions_ = trace;
+        if (resume) {
+            for (const auto& slot : slots_) {
+                slot.p_model->resume_transitions();
+            }
+        }
+    }
 
-        // using this-> is required for accessing base class methods in these cases
-        this->push(event);
-        invoke_listeners<const Time&, const Event<Time>&>(event_scheduled_listeners_, time(), event);
+    void count_skipped_transitions(const std::uint64_t count) { skipped_transitions_ += count; }
+    std::uint64_t skipped_transitions() const { return skipped_transitions_; }
+
+    // whether a skipped internal transition of the model, due at the time and scheduled at the given time, would have
+    // been executed before the input being executed: the stepped run lists concurrent events by time and scheduling
+    // order and picks between them with the select function
+    bool precedes_executing_input(const std::string& model, const Time& time, const Time& scheduled) const {
+        if (p_executing_event_ == nullptr || std::abs(time - p_executing_event_->time()) > epsilon_) {
+            return false;
+        }
+        const auto& event = *p_executing_event_;
+        const auto listed_first =
+            time < event.time() || (!(event.time() < time) && !(event.scheduled() < scheduled));
+        if (p_select_ == nullptr) {
+            return listed_first;
+        }
+        const auto names = listed_first ? std::vector<std::string>{model, event.model()}
+                                        : std::vector<std::string>{event.model(), model};
+        return select_index(names, *p_select_) == (listed_first ? 0 : 1);
     }
 
     // returns whether an event has actually been executed
     bool execute_next(const std::function<std::string(const std::vector<std::string>&)> select) {
 
-        const auto events = next();
+        auto events = next();
 
         if (events.empty()) {
             return false;
         }
 
-        const auto time = events[0].time();
+        const auto time = events[0].time;
 
         if (time > end_time_) {
             // always finish at the ending time
@@ -304,6 +1739,84 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
         return true;
     }
 
+    // time of the next pending event, if any
+    std::optional<Time> next_event_time() {
+        if (transition_first()) {
+            return transitions_.key(transitions_.top()).time;
+        }
+        const auto p_event = next_pending_event_ref();
+        if (p_event == nullptr) {
+            return std::nullopt;
+        }
+        return p_event->time();
+    }
+
+    // moves the time forward without executing events, e.g. to synchronize with other calendars
+    void advance_to(const Time& time) {
+        if (time > time_) {
+            advance_time(time);
+        }
+    }
+
+    // sequence number of the next scheduled event
+    std::uint64_t next_sequence() const { return next_sequence_; }
+
+    // start logging input event deltas for incremental checkpoints, see write_checkpoint
+    void track_changes() { tracking_ = true; }
+
+    void write_checkpoint(Checkpoint<Time>& checkpoint) {
+        checkpoint.time = time_;
+        checkpoint.executed_events = executed_events_;
+        checkpoint.next_sequence = next_sequence_;
+        if (checkpoint.full) {
+            events_.for_each([this, &checkpoint](const Event<Time>& event) {
+                checkpoint.scheduled_events.emplace_back(event, payloads_[event.payload()]);
+            });
+        } else {
+            checkpoint.scheduled_events = std::move(scheduled_log_);
+            checkpoint.removed_events = std::move(removed_log_);
+        }
+        scheduled_log_.clear();
+        removed_log_.clear();
+    }
+
+    // replaces the pending events by the input events of the checkpoint chain ending at idx
+    // the models restore their internal transitions afterwards using restore_transition
+    void restore_checkpoint(const std::vector<Checkpoint<Time>>& chain, const size_t idx) {
+        size_t base = idx;
+        while (!chain.at(base).full) {
+            --base;
+        }
+        std::unordered_map<std::uint64_t, const std::pair<Event<Time>, EventPayload>*> pending{};
+        for (size_t i = base; i <= idx; ++i) {
+            for (const auto& scheduled : chain[i].scheduled_events) {
+                pending[scheduled.first.sequence()] = std::addressof(scheduled);
+            }
+            for (const auto sequence : chain[i].removed_events) {
+                pending.erase(sequence);
+            }
+        }
+
+        events_.clear();
+        payloads_.clear();
+        bytes_ = 0;
+        scheduled_log_.clear();
+        removed_log_.clear();
+        for (const auto& [_, p_scheduled] : pending) {
+            auto event = p_scheduled->first;
+            event.set_payload(payloads_.acquire(p_scheduled->second));
+            push_event(event);
+        }
+        time_ = chain[idx].time;
+        executed_events_ = chain[idx].executed_events;
+        next_sequence_ = chain[idx].next_sequence;
+    }
+
+    // reschedule an internal transition under its original sequence number
+    void restore_transition(const size_t slot, const Time& time, const std::uint64_t sequence) {
+        transitions_.update(slot, {time, sequence});
+    }
+
     void add_time_advanced_listener(const Listener<const Time&, const Time&> listener) {
         time_advanced_listeners_.push_back(listener);
     }
@@ -316,6 +1829,30 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
         executing_event_action_listeners_.push_back(listener);
     }
 
+  private: // static members
+    // operations between two evaluations of the event set cost model
+    static constexpr std::uint64_t ADAPT_INTERVAL = 4096;
+    static constexpr double HOLD_SMOOTHING = 1.0 / 1024;
+    // calendar queue operation cost relative to a binary heap comparison, for evenly spread hold times
+    static constexpr double CALENDAR_QUEUE_COST = 6.0;
+    // relative cost advantage required for migrating
+    static constexpr double MIGRATION_HYSTERESIS = 0.25;
+    // migration cost per pending event, in the same units
+    static constexpr double MIGRATION_COST = 2.0;
+
+  private: // types
+    struct TransitionSlot {
+        IOModel<Time>* p_model;
+    };
+
+    // an input event or the internal transition of a slot, which is stale once the slot has been rescheduled
+    struct Imminent {
+        Time time;
+        std::uint64_t sequence;
+        std::optional<Event<Time>> event;
+        size_t slot;
+    };
+
   private: // static functions
     static size_t select_index(const std::vector<std::string>& names,
                                const std::function<std::string(const std::vector<std::string>&)>& select) {
@@ -328,18 +1865,77 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
     }
 
   private: // methods
-    void pop_cancelled_events() {
-        while (!this->empty() && this->top().is_cancelled()) {
-            this->pop();
+    void push_event(const Event<Time>& event) {
+        events_.push(event);
+        record_hold_time(static_cast<double>(event.time() - time_));
+        count_operation();
+        bytes_ += event.memory_usage();
+        peak_bytes_ = std::max(peak_bytes_, bytes_);
+        if (tracking_) {
+            scheduled_log_.emplace_back(event, payloads_[event.payload()]);
+        }
+    }
+
+    void pop_event() {
+        const auto& event = events_.top();
+        bytes_ -= event.memory_usage();
+        if (tracking_) {
+            removed_log_.push_back(event.sequence());
         }
+        events_.pop();
+        count_operation();
     }
 
     const Event<Time>* next_pending_event_ref() {
-        pop_cancelled_events();
-        if (this->empty()) {
+        if (events_.empty()) {
             return nullptr;
         }
-        return std::addressof(this->top());
+        return std::addressof(events_.top());
+    }
+
+    void record_hold_time(const double hold) {
+        if (!std::isfinite(hold)) {
+            return;
+        }
+        const auto delta = hold - hold_mean_;
+        hold_mean_ += HOLD_SMOOTHING * delta;
+        hold_variance_ = (1.0 - HOLD_SMOOTHING) * (hold_variance_ + HOLD_SMOOTHING * delta * delta);
+    }
+
+    void count_operation() {
+        if (++window_operations_ >= ADAPT_INTERVAL) {
+            adapt();
+        }
+    }
+
+    // comparisons per operation, logarithmic for the binary heap, constant for the calendar queue as long as the
+    // hold times are evenly spread (a wide spread leaves the width estimate with crowded or empty buckets)
+    double operation_cost(const EventSetKind kind) const {
+        if (kind == EventSetKind::BINARY_HEAP) {
+            return std::log2(static_cast<double>(events_.size()) + 1.0);
+        }
+        const auto spread = hold_mean_ > 0.0 ? std::sqrt(hold_variance_) / hold_mean_ : 0.0;
+        return CALENDAR_QUEUE_COST * (1.0 + spread);
+    }
+
+    // migrate when the predicted savings until the pending events drain outweigh the migration
+    void adapt() {
+        window_operations_ = 0;
+        if (!adaptive_) {
+            return;
+        }
+        const auto current = events_.kind();
+        const auto other =
+            current == EventSetKind::BINARY_HEAP ? EventSetKind::CALENDAR_QUEUE : EventSetKind::BINARY_HEAP;
+        const auto current_cost = operation_cost(current);
+        const auto other_cost = operation_cost(other);
+        const auto pending = static_cast<double>(events_.size());
+        const auto operations = std::max(pending, static_cast<double>(ADAPT_INTERVAL));
+        if (other_cost < (1.0 - MIGRATION_HYSTERESIS) * current_cost &&
+            (current_cost - other_cost) * operations > MIGRATION_COST * pending) {
+            events_.migrate(other);
+            ++migrations_;
+        }
     }
 
     std::optional<Event<Time>> next_pending_event() {
@@ -349,65 +1945,142 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
         }
         // create copy from reference before deleting
         const Event<Time> event = *next;
-        this->pop();
+        pop_event();
+        return event;
+    }
+
+    size_t slots_memory_usage() const {
+        return transitions_.memory_usage() + slots_.capacity() * sizeof(TransitionSlot);
+    }
+
+    Event<Time> transition_event(const size_t slot) const {
+        const auto& key = transitions_.key(slot);
+        Event<Time> event{key.time, EventKind::INTERNAL_TRANSITION, slots_[slot].p_model};
+        event.set_sequence(key.sequence);
         return event;
     }
 
-    bool has_next_pending_event() { return next_pending_event_ref() != nullptr; }
+    // whether the earliest pending item is an internal transition, equal keys cannot occur (unique sequences)
+    bool transition_first() {
+        if (transitions_.size() == 0) {
+            return false;
+        }
+        const auto p_event = next_pending_event_ref();
+        if (p_event == nullptr) {
+            return true;
+        }
+        const auto& key = transitions_.key(transitions_.top());
+        return key.time < p_event->time() || (!(p_event->time() < key.time) && key.sequence < p_event->sequence());
+    }
+
+    std::optional<Imminent> next_pending() {
+        if (transition_first()) {
+            const auto slot = transitions_.top();
+            const auto key = transitions_.key(slot);
+            // taken out until the model reschedules, the sequence identifies the taken transition
+            transitions_.update(slot, {TournamentTree<Time>::NEVER, key.sequence});
+            return Imminent{key.time, key.sequence, std::nullopt, slot};
+        }
+        auto event = next_pending_event();
+        if (!event) {
+            return {};
+        }
+        const auto time = event->time();
+        const auto sequence = event->sequence();
+        return Imminent{time, sequence, std::move(event), 0};
+    }
 
-    bool is_next_pending_event_concurrent(const Time& time) {
-        return has_next_pending_event() && std::abs(next_pending_event_ref()->time() - time) <= epsilon_;
+    bool is_next_pending_concurrent(const Time& time) {
+        const auto next = next_event_time();
+        return next && std::abs(*next - time) <= epsilon_;
     }
 
-    std::optional<Event<Time>> next_pending_concurrent_event(const Time& time) {
-        if (!is_next_pending_event_concurrent(time)) {
+    std::optional<Imminent> next_pending_concurrent(const Time& time) {
+        if (!is_next_pending_concurrent(time)) {
             return {};
         }
-        return next_pending_event();
+        return next_pending();
     }
 
-    std::vector<Event<Time>> next() {
-        const auto event = next_pending_event();
-        if (!event) {
+    std::vector<Imminent> next() {
+        auto imminent = next_pending();
+        if (!imminent) {
             return {};
         }
-        std::vector<Event<Time>> concurrent_events{*event};
-        while (const auto concurrent_event = next_pending_concurrent_event(event->time())) {
-            concurrent_events.push_back(*concurrent_event);
+        const auto time = imminent->time;
+        std::vector<Imminent> concurrent_events{std::move(*imminent)};
+        while (auto concurrent_event = next_pending_concurrent(time)) {
+            concurrent_events.push_back(std::move(*concurrent_event));
         }
 
         return concurrent_events;
     }
 
-    void execute_concurrent_events(std::vector<Event<Time>> events,
+    const std::string& model_of(const Imminent& imminent) const {
+        return imminent.event ? imminent.event->model() : slots_[imminent.slot].p_model->name();
+    }
+
+    // internal transitions rescheduled by a concurrent event are skipped, input events are never stale
+    bool is_stale(const Imminent& imminent) const {
+        return !imminent.event && transitions_.key(imminent.slot).sequence != imminent.sequence;
+    }
+
+    void execute_concurrent_events(std::vector<Imminent> events,
                                    const std::function<std::string(const std::vector<std::string>&)> select) {
 
+        p_select_ = std::addressof(select);
+
         // map events to model names
         std::vector<std::string> names;
-        for (const auto event : events) {
-            names.push_back(event.model());
+        for (const auto& event : events) {
+            names.push_back(model_of(event));
         }
 
         while (!events.empty()) {
             const auto idx{names.size() > 1 ? select_index(names, select) : 0};
-            const auto& event{events[idx]};
-            // check if other concurrent events did not cancel this event
-            if (!event.is_cancelled()) {
-                execute_event_action(event);
-                // push possible newly created events
-                while (const auto new_concurrent = next_pending_concurrent_event(event.time())) {
-                    events.push_back(*new_concurrent);
-                    names.push_back(new_concurrent->model());
+            // check if other concurrent events did not reschedule this internal transition
+            if (!is_stale(events[idx])) {
+                const auto time = events[idx].time;
+                execute(events[idx]);
+                // push possible newly created events, pushing invalidates the event reference
+                while (auto new_concurrent = next_pending_concurrent(time)) {
+                    names.push_back(model_of(*new_concurrent));
+                    events.push_back(std::move(*new_concurrent));
                 }
             }
             events.erase(events.begin() + idx);
             names.erase(names.begin() + idx);
         }
+        p_select_ = nullptr;
+    }
+
+    void execute(const Imminent& imminent) {
+        if (imminent.event) {
+            execute_event_action(*imminent.event);
+            return;
+        }
+        const auto p_model = slots_[imminent.slot].p_model;
+        DEVS_PROBE4(event__execute, probe_time(imminent.time), p_model->name().c_str(),
+                    static_cast<int>(EventKind::INTERNAL_TRANSITION), imminent.sequence);
+        if (trace_events_ && !executing_event_action_listeners_.empty()) {
+            Event<Time> event{imminent.time, EventKind::INTERNAL_TRANSITION, p_model};
+            event.set_sequence(imminent.sequence);
+            invoke_listeners<const Time&, const Event<Time>&>(executing_event_action_listeners_, time(), event);
+        }
+        p_model->execute_internal_transition();
+        ++executed_events_;
     }
 
     void execute_event_action(const Event<Time>& event) {
-        invoke_listeners<const Time&, const Event<Time>&>(executing_event_action_listeners_, time(), event);
-        event.action();
+        DEVS_PROBE4(event__execute, probe_time(event.time()), event.model().c_str(), static_cast<int>(event.kind()),
+                    event.sequence());
+        if (trace_events_) {
+            invoke_listeners<const Time&, const Event<Time>&>(executing_event_action_listeners_, time(), event);
+        }
+        p_executing_event_ = std::addressof(event);
+        event.target().dispatch(event, payloads_.release(event.payload()));
+        p_executing_event_ = nullptr;
+        ++executed_events_;
     }
 
     void advance_time(const Time& time) {
@@ -418,19 +2091,124 @@ template <typename Time> class Calendar : private CalendarBase<Time> {
     }
 
   private: // members
+    EventSet<Time> events_;
+    EventPayloads payloads_;
+    std::unordered_set<std::string> names_;
     Time time_;
     Time end_time_;
     Time epsilon_;
+    std::uint64_t executed_events_;
+    size_t bytes_;
+    size_t peak_bytes_;
+    std::uint64_t next_sequence_;
+    bool tracking_;
+    std::vector<std::pair<Event<Time>, EventPayload>> scheduled_log_;
+    std::vector<std::uint64_t> removed_log_;
+    // pending internal transitions of the atomic models, the input events stay in events_
+    TournamentTree<Time> transitions_;
+    std::vector<TransitionSlot> slots_;
     Listeners<const Time&, const Time&> time_advanced_listeners_;
     Listeners<const Time&, const Event<Time>&> event_scheduled_listeners_;
     Listeners<const Time&, const Event<Time>&> executing_event_action_listeners_;
+    // the input being dispatched and the select function ordering the concurrent events, while executing them
+    const Event<Time>* p_executing_event_{nullptr};
+    const std::function<std::string(const std::vector<std::string>&)>* p_select_{nullptr};
+    bool adaptive_{true};
+    bool trace_events_{true};
+    bool trace_transitions_{true};
+    std::uint64_t kept_transitions_{};
+    std::uint64_t rescheduled_transitions_{};
+    std::uint64_t skipped_transitions_{};
+    std::uint64_t migrations_{};
+    std::uint64_t window_operations_{};
+    double hold_mean_{};
+    double hold_variance_{};
+};
+
+// bump allocator keeping the models of a compound hierarchy contiguous in their construction order
+// models are never freed individually, the memory is released together with the arena
+class ModelArena {
+  public: // types
+    // routes the model allocations of the calling thread into the arena while alive
+    class Scope {
+      public: // ctors, dtor
+        explicit Scope(ModelArena& arena) : p_previous_{current_} { current_ = std::addressof(arena); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() { current_ = p_previous_; }
+
+      private: // members
+        ModelArena* p_previous_;
+    };
+
+  public: // ctors, dtor
+    ModelArena() = default;
+    ModelArena(const ModelArena&) = delete;
+    ModelArena& operator=(const ModelArena&) = delete;
+
+  public: // static functions
+    static bool active() { return current_ != nullptr; }
+
+    static void* allocate(const size_t bytes) {
+        const auto total = bytes + HEADER;
+        auto p_block = current_ != nullptr ? current_->bump(total) : static_cast<std::byte*>(::operator new(total));
+        // the header tags the origin of the memory for deallocate
+        *p_block = current_ != nullptr ? ARENA_TAG : HEAP_TAG;
+        return p_block + HEADER;
+    }
+
+    static void deallocate(void* p) {
+        if (p == nullptr) {
+            return;
+        }
+        const auto p_block = static_cast<std::byte*>(p) - HEADER;
+        if (*p_block == HEAP_TAG) {
+            ::operator delete(p_block);
+        }
+    }
+
+  private: // static members
+    static constexpr size_t HEADER = alignof(std::max_align_t);
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+    static constexpr std::byte HEAP_TAG{0};
+    static constexpr std::byte ARENA_TAG{1};
+    static inline thread_local ModelArena* current_{nullptr};
+
+  private: // methods
+    std::byte* bump(size_t bytes) {
+        bytes = (bytes + HEADER - 1) / HEADER * HEADER;
+        if (blocks_.empty() || used_ + bytes > capacity_) {
+            capacity_ = std::max(bytes, BLOCK_BYTES);
+            blocks_.push_back(std::make_unique<std::byte[]>(capacity_));
+            used_ = 0;
+        }
+        const auto p = blocks_.back().get() + used_;
+        used_ += bytes;
+        return p;
+    }
+
+  private: // members
+    std::vector<std::unique_ptr<std::byte[]>> blocks_{};
+    size_t used_{};
+    size_t capacity_{};
 };
 
 template <typename Time> class IOModel {
 
+  public: // static functions
+    // models built inside a compound are placed into its arena, see CompoundImpl
+    static void* operator new(const size_t bytes) { return ModelArena::allocate(bytes); }
+    static void operator delete(void* p) { ModelArena::deallocate(p); }
+    // over-aligned models bypass the arena
+    static void* operator new(const size_t bytes, const std::align_val_t alignment) {
+        return ::operator new(bytes, alignment);
+    }
+    static void operator delete(void* p, const std::align_val_t alignment) { ::operator delete(p, alignment); }
+
   public: // ctors, dtor
     explicit IOModel(const std::string name, Calendar<Time>* p_calendar)
-        : state_transition_listeners_{}, name_{name}, p_calendar_{p_calendar}, input_listeners_{}, output_listeners_{} {
+        : state_transition_listeners_{}, name_{name}, p_calendar_{p_calendar}, input_listeners_{}, output_listeners_{},
+          parameter_listener_{}, input_sources_{}, batch_output_listeners_{} {
         if (name.empty()) {
             throw std::runtime_error("Model name should not be empty");
         }
@@ -443,23 +2221,39 @@ template <typename Time> class IOModel {
 
     virtual const std::unordered_map<std::string, std::unique_ptr<IOModel<Time>>>* components() const = 0;
     virtual std::optional<Dynamic> state() const = 0;
+    // message types for validating the couplings, unknown for compound models
+    virtual std::optional<std::type_index> input_type() const = 0;
+    virtual std::optional<std::type_index> output_type() const = 0;
     virtual const std::function<std::string(const std::vector<std::string>&)> select() const = 0;
     virtual void add_state_transition_listener(
         const Listener<const std::string&, const Time&, const std::string&, const std::string&> listener) = 0;
+    // invoked after every transition with the model name, time and Devs::Traits::StateHash of the new state
+    virtual void
+    add_state_hash_listener(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) = 0;
 
     virtual void sim_started(const Listener<const std::string&, const Time&, const std::string&> listener) const = 0;
     virtual void sim_ended(const Listener<const std::string&, const Time&, const std::string&> listener) const = 0;
+    // reports the current and peak state bytes of every atomic model
+    virtual void memory_usage(const Listener<const std::string&, const size_t&, const size_t&> listener) const = 0;
+    // reports the next internal transition time and the executed transition count of every atomic model
+    virtual void activity(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) const = 0;
+    // store the state of every atomic model that transitioned since the previous checkpoint (all of them when full)
+    virtual void write_checkpoint(Checkpoint<Time>& checkpoint) = 0;
+    // restore the states from the checkpoint chain ending at idx, after the calendar has been restored
+    virtual void restore_checkpoint(const std::vector<Checkpoint<Time>>& chain, const size_t idx) = 0;
 
     void input_from_influencer(const std::string& from, const Time& time, const Dynamic& value,
-                               const Devs::Model::Transformer& transformer) const {
+                               const Devs::Model::Transformer& transformer) {
+#if DEVS_CHECKED
+        // self-influence loops are rejected when connecting the components
         if (from == name()) {
             throw std::runtime_error("Model " + name() + " contains a forbidden self-influence loop");
         }
-        schedule_event(Event<Time>{time,
-                                   [this, from, value, transformer]() {
-                                       invoke_input_listeners(from, influencer_transform(from, value, transformer));
-                                   },
-                                   name(), "influencer input"});
+#endif
+        DEVS_PROBE3(message__route, probe_time(time), from.c_str(), name().c_str());
+        // transformed when sent, the event only keeps the resulting value
+        schedule_input(time, EventKind::INFLUENCER_INPUT,
+                       {influencer_transform(from, value, transformer), p_calendar_->intern(from), 0});
     }
 
     // directly invoked input
@@ -469,66 +2263,243 @@ template <typename Time> class IOModel {
         invoke_input_listeners(from, influencer_transform(from, value, transformer));
     }
 
-    void external_input(const Time& time, const Dynamic& value, const std::string& description) const {
-        schedule_event(
-            Event<Time>{time, [this, value]() { invoke_input_listeners(name(), value); }, name(), description});
+    virtual void external_input(const Time& time, const Dynamic& value, const std::string& description) {
+        schedule_input(time, EventKind::EXTERNAL_INPUT, {value, nullptr, 0}, p_calendar_->intern(description));
     }
 
-    void add_output_listener(const Listener<const std::string&, const Time&, const Dynamic&> listener) {
-        output_listeners_.push_back(listener);
+    // the update is a Devs::Model::ParameterUpdate of the state, only atomic models accept them
+    void parameter_update(const Time& time, const Dynamic& update, const std::string& description) {
+        if (!parameter_listener_) {
+            throw std::runtime_error("Parameter updates are only accepted by atomic models, model " + name());
+        }
+        schedule_input(time, EventKind::PARAMETER_UPDATE, {update, nullptr, 0}, p_calendar_->intern(description));
     }
 
-  protected: // methods
-    void schedule_event(const Event<Time> event) const { p_calendar_->schedule_event(event); }
+    // executes an input event targeting this model with its payload, released from the pool of the calendar
+    void dispatch(const Event<Time>& event, const EventPayload& payload) {
+        switch (event.kind()) {
+        case EventKind::INFLUENCER_INPUT:
+            invoke_input_listeners(*payload.p_from, payload.value);
+            break;
+        case EventKind::EXTERNAL_INPUT:
+            route_external_input(payload.value);
+            break;
+        case EventKind::SOURCE_INPUT:
+            route_external_input(payload.value);
+            schedule_next_source_input(payload.index);
+            break;
+        case EventKind::PARTITION_INPUT:
+            route_partition_input(payload.index, payload.value);
+            break;
+        case EventKind::PARAMETER_UPDATE:
+            parameter_listener_(payload.value);
+            break;
+        case EventKind::INTERNAL_TRANSITION:
+            throw std::runtime_error("Internal transitions are executed from the transition slots, model " + name());
+        }
+    }
 
-    const Time& calendar_time() const { return p_calendar_->time(); }
+    // invoked by the calendar when the transition of the slot of the model (see add_transition_slot) is due
+    virtual void execute_internal_transition() {}
+    // invoked by the calendar when the transitions become traced, models skipping them catch up (see AtomicImpl)
+    virtual void resume_transitions() {}
+    // invoked before the states are reported (end of the simulation, introspection), models skipping their internal
+    // transitions apply the ones due before the calendar time
+    virtual void catch_up() {}
+
+    // inputs pulled from the source one at a time, each one is scheduled when the previous one is delivered
+    void external_input_source(const Devs::Model::InputSource<Time> source, const std::string& description) {
+        input_sources_.push_back({source, p_calendar_->intern(description), true});
+        schedule_next_source_input(input_sources_.size() - 1);
+    }
 
-    void output(const Dynamic& value) const {
-        // using output events is redundant, invoke directly
-        // when necessary, the listener sets up input events
-        invoke_output_listeners(value);
+    void add_output_listener(const Listener<const std::string&, const Time&, const Dynamic&> listener) {
+        output_listeners_.push_back(listener);
     }
 
-    void state_transitioned(const std::string& prev, const std::string& next) const {
-        if (prev != next) {
-            invoke_listeners<const std::string&, const Time&, const std::string&, const std::string&>(
-                state_transition_listeners_, name(), calendar_time(), prev, next);
-        }
+    // the outputs are buffered and delivered at once (contiguous, in time order) when their time advances beyond the
+    // calendar epsilon or, given a capacity, when the buffer is full, the rest is delivered at the end of the run (see
+    // flush_output_batches)
+    void add_batch_output_listener(
+        const Listener<const std::string&, const std::vector<Devs::Model::Output<Time>>&> listener,
+        const size_t capacity = 0) {
+        batch_output_listeners_.push_back({listener, capacity, {}});
+        batch_output_listeners_.back().outputs.reserve(capacity);
+    }
+
+    // delivers the buffered outputs of the model and of its components
+    virtual void flush_output_batches() const {
+        for (auto& entry : batch_output_listeners_) {
+            flush_output_batch(entry);
+        }
+    }
+
+  private: // types
+    struct SourceEntry {
+        Devs::Model::InputSource<Time> source;
+        // interned by the calendar
+        const std::string* p_description;
+        bool advanced;
+    };
+
+    struct BatchEntry {
+        Listener<const std::string&, const std::vector<Devs::Model::Output<Time>>&> listener;
+        size_t capacity;
+        // cleared after every delivery, keeping the allocation
+        std::vector<Devs::Model::Output<Time>> outputs;
+    };
+
+  protected: // methods
+    void schedule_input(const Time& time, const EventKind kind, EventPayload payload,
+                        const std::string* p_description = nullptr) {
+        p_calendar_->schedule_input(time, kind, this, std::move(payload), p_description);
+    }
+
+    void write_sources_checkpoint(Checkpoint<Time>& checkpoint) {
+        for (size_t idx = 0; idx < input_sources_.size(); ++idx) {
+            auto& entry = input_sources_[idx];
+            if (entry.advanced || checkpoint.full) {
+                checkpoint.sources.emplace(std::make_pair(this, idx), entry.source);
+                entry.advanced = false;
+            }
+        }
+    }
+
+    void restore_sources_checkpoint(const std::vector<Checkpoint<Time>>& chain, const size_t idx) {
+        for (size_t source_idx = 0; source_idx < input_sources_.size(); ++source_idx) {
+            const auto key = std::make_pair(static_cast<const IOModel<Time>*>(this), source_idx);
+            bool restored{false};
+            for (size_t i = idx + 1; i-- > 0 && !restored;) {
+                const auto it = chain[i].sources.find(key);
+                if (it != chain[i].sources.end()) {
+                    input_sources_[source_idx].source = it->second;
+                    input_sources_[source_idx].advanced = false;
+                    restored = true;
+                }
+            }
+            if (!restored) {
+                throw std::runtime_error("Missing checkpoint state of an input source of model " + name());
+            }
+        }
+    }
+
+    void schedule_next_source_input(const size_t idx) {
+        auto& entry = input_sources_[idx];
+        entry.advanced = true;
+        if (auto input = entry.source()) {
+            schedule_input(input->time, EventKind::SOURCE_INPUT, {std::move(input->value), nullptr, idx},
+                           entry.p_description);
+        }
+    }
+
+    size_t add_transition_slot() { return p_calendar_->add_transition_slot(this); }
+
+    void schedule_transition(const size_t slot, const Time& time) const {
+        p_calendar_->schedule_transition(slot, time);
+    }
+
+    void restore_transition(const size_t slot, const Time& time, const std::uint64_t sequence) const {
+        p_calendar_->restore_transition(slot, time, sequence);
+    }
+
+    void transition_kept() const { p_calendar_->count_kept_transition(); }
+
+    void transition_rescheduled() const { p_calendar_->count_rescheduled_transition(); }
+
+    void transitions_skipped(const std::uint64_t count) const { p_calendar_->count_skipped_transitions(count); }
+
+    bool transitions_traced() const { return p_calendar_->traces_transitions(); }
+
+    bool transition_precedes_input(const Time& time, const Time& scheduled) const {
+        return p_calendar_->precedes_executing_input(this->name(), time, scheduled);
+    }
+
+    bool has_output_listeners() const { return !output_listeners_.empty() || !batch_output_listeners_.empty(); }
+
+    const Time& calendar_time() const { return p_calendar_->time(); }
+
+    const Time& calendar_end_time() const { return p_calendar_->end_time(); }
+
+    const Time& calendar_epsilon() const { return p_calendar_->epsilon(); }
+
+    std::uint64_t next_event_sequence() const { return p_calendar_->next_sequence(); }
+
+    void output(const Dynamic& value) const { output(value, calendar_time()); }
+
+    void output(const Dynamic& value, const Time& time) const {
+        // using output events is redundant, invoke directly
+        // when necessary, the listener sets up input events
+        invoke_output_listeners(value, time);
+    }
+
+    // delivers an external input (scheduled or from a source) to the input listeners
+    virtual void route_external_input(const Dynamic& value) const { invoke_input_listeners(name(), value); }
+
+    // delivers an external input to a partition of the model, see CompoundImpl
+    virtual void route_partition_input(const size_t, const Dynamic&) const {}
+
+    void state_transitioned(const std::string& prev, const std::string& next) const {
+        if (prev != next) {
+            invoke_listeners<const std::string&, const Time&, const std::string&, const std::string&>(
+                state_transition_listeners_, name(), calendar_time(), prev, next);
+        }
     }
 
     void add_input_listener(const Listener<const std::string&, const Dynamic&> listener) {
         input_listeners_.push_back(listener);
     }
 
+    void set_parameter_listener(const Listener<const Dynamic&> listener) { parameter_listener_ = listener; }
+
     Dynamic influencer_transform(const std::string& influencer, const Dynamic& value,
-                                 const std::optional<std::function<Dynamic(const Dynamic&)>> transformer) const {
-        try {
-            if (transformer) {
-                return (*transformer)(value);
-            }
-            return value;
-        } catch (const std::bad_cast&) {
-            std::stringstream s{};
-            s << "Invalid dynamic cast in transformer function for influencer " << influencer << " in model " << name();
-            throw std::runtime_error(s.str());
-        }
+                                 const Devs::Model::Transformer& transformer) const {
+        return checked_cast(
+            [&]() {
+                if (transformer) {
+                    return (*transformer)(value);
+                }
+                return value;
+            },
+            [&]() {
+                std::stringstream s{};
+                s << "Invalid dynamic cast in transformer function for influencer " << influencer << " in model "
+                  << name();
+                return s.str();
+            });
     }
 
     void invoke_input_listeners(const std::string& from, const Dynamic& value) const {
-        try {
-            invoke_listeners<const std::string&, const Dynamic&>(input_listeners_, from, value);
-        } catch (std::bad_cast&) {
-            throw std::runtime_error("Invalid type cast in input listener of model " + name());
+        checked_cast([&]() { invoke_listeners<const std::string&, const Dynamic&>(input_listeners_, from, value); },
+                     [&]() { return "Invalid type cast in input listener of model " + name(); });
+    }
+
+    void invoke_output_listeners(const Dynamic& value, const Time& time) const {
+        checked_cast(
+            [&]() {
+                invoke_listeners<const std::string&, const Time&, const Dynamic&>(output_listeners_, name(), time,
+                                                                                  value);
+            },
+            [&]() { return "Invalid type cast in output listener of model " + name(); });
+        for (auto& entry : batch_output_listeners_) {
+            // a timestep spans the concurrent times from its first output
+            if (entry.capacity == 0 && !entry.outputs.empty() &&
+                entry.outputs.front().time + calendar_epsilon() < time) {
+                flush_output_batch(entry);
+            }
+            entry.outputs.push_back({time, value});
+            if (entry.capacity != 0 && entry.outputs.size() >= entry.capacity) {
+                flush_output_batch(entry);
+            }
         }
     }
 
-    void invoke_output_listeners(const Dynamic& value) const {
-        try {
-            invoke_listeners<const std::string&, const Time&, const Dynamic&>(output_listeners_, name(),
-                                                                              calendar_time(), value);
-        } catch (std::bad_cast&) {
-            throw std::runtime_error("Invalid type cast in output listener of model " + name());
+    void flush_output_batch(BatchEntry& entry) const {
+        if (entry.outputs.empty()) {
+            return;
         }
+        checked_cast([&]() { entry.listener(name(), entry.outputs); },
+                     [&]() { return "Invalid type cast in batch output listener of model " + name(); });
+        entry.outputs.clear();
     }
 
   protected: // members
@@ -539,6 +2510,10 @@ template <typename Time> class IOModel {
     Calendar<Time>* p_calendar_;
     Listeners<const std::string&, const Dynamic&> input_listeners_;
     Listeners<const std::string&, const Time&, const Dynamic&> output_listeners_;
+    Listener<const Dynamic&> parameter_listener_;
+    std::vector<SourceEntry> input_sources_;
+    // outputs are delivered from the const output functions
+    mutable std::vector<BatchEntry> batch_output_listeners_;
 };
 
 template <typename X, typename Y, typename S, typename Time> class AtomicImpl : public IOModel<Time> {
@@ -546,13 +2521,28 @@ template <typename X, typename Y, typename S, typename Time> class AtomicImpl :
   public: // ctors, dtor
     explicit AtomicImpl(const std::string name, const Devs::Model::Atomic<X, Y, S, Time> model,
                         Calendar<Time>* p_calendar)
-        : IOModel<Time>{name, p_calendar}, model_{model}, last_transition_time_{}, cancel_internal_transition_{} {
+        : IOModel<Time>{name, p_calendar}, model_{model}, last_transition_time_{p_calendar->time()},
+          transition_slot_{this->add_transition_slot()},
+          state_bytes_{Devs::Traits::StateSize<S>::bytes(model_.s)}, peak_state_bytes_{state_bytes_},
+          next_internal_transition_time_{}, transitions_{0}, state_hash_listeners_{}, dirty_{true},
+          internal_transition_sequence_{0}, skipping_{false} {
 
         this->add_input_listener(
             [this](const std::string& from, const Dynamic& input) { dynamic_input_listener(from, input); });
-        schedule_internal_transition();
+        this->set_parameter_listener([this](const Dynamic& update) { dynamic_parameter_listener(update); });
+        schedule_internal_transition(internal_transition_time());
     }
 
+  private: // types
+    struct Snapshot {
+        S s;
+        Time last_transition_time;
+        Time next_internal_transition_time;
+        std::uint64_t internal_transition_sequence;
+        std::uint64_t transitions;
+        bool skipping;
+    };
+
   private: // static functions
     static std::string state_to_str(const S& state) {
         std::stringstream s;
@@ -567,6 +2557,10 @@ template <typename X, typename Y, typename S, typename Time> class AtomicImpl :
 
     std::optional<Dynamic> state() const override { return model_.s; }
 
+    std::optional<std::type_index> input_type() const override { return std::type_index{typeid(X)}; }
+
+    std::optional<std::type_index> output_type() const override { return std::type_index{typeid(Y)}; }
+
     const S& atomic_state() const { return model_.s; }
 
     void sim_started(const Listener<const std::string&, const Time&, const std::string&> listener) const override {
@@ -577,6 +2571,50 @@ template <typename X, typename Y, typename S, typename Time> class AtomicImpl :
         listener(this->name(), this->calendar_time(), state_to_str(atomic_state()));
     }
 
+    void memory_usage(const Listener<const std::string&, const size_t&, const size_t&> listener) const override {
+        listener(this->name(), state_bytes_, peak_state_bytes_);
+    }
+
+    void activity(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) const override {
+        listener(this->name(), next_internal_transition_time_, transitions_);
+    }
+
+    void write_checkpoint(Checkpoint<Time>& checkpoint) override {
+        this->write_sources_checkpoint(checkpoint);
+        if (skipping_) {
+            fast_forward(this->calendar_time(), false);
+        }
+        if (dirty_ || checkpoint.full) {
+            checkpoint.states.emplace(this, Snapshot{atomic_state(), last_transition_time_,
+                                                     next_internal_transition_time_, internal_transition_sequence_,
+                                                     transitions_, skipping_});
+            dirty_ = false;
+        }
+    }
+
+    void restore_checkpoint(const std::vector<Checkpoint<Time>>& chain, const size_t idx) override {
+        this->restore_sources_checkpoint(chain, idx);
+        // the latest snapshot at or before idx, every model is part of the full checkpoint at the chain start
+        for (size_t i = idx + 1; i-- > 0;) {
+            const auto it = chain[i].states.find(this);
+            if (it == chain[i].states.end()) {
+                continue;
+            }
+            const auto snapshot = it->second.template value<Snapshot>();
+            model_.s = snapshot.s;
+            last_transition_time_ = snapshot.last_transition_time;
+            transitions_ = snapshot.transitions;
+            update_state_bytes();
+            dirty_ = false;
+            next_internal_transition_time_ = snapshot.next_internal_transition_time;
+            internal_transition_sequence_ = snapshot.internal_transition_sequence;
+            skipping_ = snapshot.skipping;
+            this->restore_transition(transition_slot_, next_internal_transition_time_, internal_transition_sequence_);
+            return;
+        }
+        throw std::runtime_error("Missing checkpoint state of model " + this->name());
+    }
+
     const std::function<std::string(const std::vector<std::string>&)> select() const override {
         // use fifo selector in an atomic simulation
         return Devs::Model::Compound<Time>::fifo_selector;
@@ -587,64 +2625,199 @@ template <typename X, typename Y, typename S, typename Time> class AtomicImpl :
         this->state_transition_listeners_.push_back(listener);
     }
 
+    void
+    add_state_hash_listener(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) override {
+        state_hash_listeners_.push_back(listener);
+    }
+
     void transition_state(const S new_state) {
         this->state_transitioned(state_to_str(atomic_state()), state_to_str(new_state));
         model_.s = new_state;
         update_last_transition_time();
+        update_state_bytes();
+        ++transitions_;
+        dirty_ = true;
+        // hashing is opt-in, skip it entirely without listeners
+        if (!state_hash_listeners_.empty()) {
+            invoke_listeners<const std::string&, const Time&, const std::uint64_t&>(
+                state_hash_listeners_, this->name(), this->calendar_time(),
+                Devs::Traits::StateHash<S>::hash(atomic_state()));
+        }
+    }
+
+    void update_state_bytes() {
+        state_bytes_ = Devs::Traits::StateSize<S>::bytes(atomic_state());
+        peak_state_bytes_ = std::max(peak_state_bytes_, state_bytes_);
     }
 
     Time time_advance() const { return model_.ta(atomic_state()); }
 
-    Time internal_transition_time() const { return this->calendar_time() + time_advance(); }
+    // equals the calendar time plus the time advance, except after fast-forwarding
+    Time internal_transition_time() const { return last_transition_time_ + time_advance(); }
+
+    // skipping replaces the internal transitions up to the end of the simulation by a single wake-up at the end
+    Time next_internal_transition() {
+        const auto time = internal_transition_time();
+        skipping_ = model_.period && !(this->calendar_end_time() < time) && !this->transitions_traced() &&
+                    !this->has_output_listeners() && state_hash_listeners_.empty() && model_.period(atomic_state());
+        return skipping_ ? this->calendar_end_time() : time;
+    }
+
+    // transitions without inputs within a period starting with the next one of the state, which is due at once when
+    // an input consumed the whole time advance
+    std::uint64_t period_transitions(S s, const Time& period) const {
+        // tolerate the rounding of the time advances summing up to the period
+        const auto first = model_.ta(s);
+        const auto limit = first + period - period * std::numeric_limits<Time>::epsilon() * 16;
+        std::uint64_t transitions = 0;
+        for (auto elapsed = first; elapsed < limit; elapsed += model_.ta(s)) {
+            s = model_.delta_internal(s);
+            ++transitions;
+        }
+        return transitions;
+    }
+
+    // applies the skipped internal transitions due before the time (or at it when inclusive) without producing
+    // outputs or notifying the listeners, whole periods are skipped at once
+    void fast_forward(const Time& time, const bool inclusive) {
+        auto s = atomic_state();
+        auto last_transition_time = last_transition_time_;
+        std::uint64_t transitions = 0;
+        if (const auto period = model_.period(s); period && Time{} < *period) {
+            // leave the last period to the replay below, the rounding at the period boundaries stays there
+            const auto periods = std::floor((time - last_transition_time) / *period) - 1;
+            if (periods >= 1) {
+                last_transition_time += periods * *period;
+                transitions += static_cast<std::uint64_t>(periods) * period_transitions(s, *period);
+            }
+        }
+        const auto due = [&](const Time& next) { return next < time || (inclusive && !(time < next)); };
+        for (auto next = last_transition_time + model_.ta(s); due(next); next = last_transition_time + model_.ta(s)) {
+            last_transition_time = next;
+            s = model_.delta_internal(s);
+            ++transitions;
+        }
+        if (transitions == 0) {
+            return;
+        }
+        model_.s = s;
+        last_transition_time_ = last_transition_time;
+        transitions_ += transitions;
+        update_state_bytes();
+        dirty_ = true;
+        this->transitions_skipped(transitions);
+    }
+
+    // catches up before an input, a skipped internal transition coinciding with it is ordered like the stepped run
+    // would, by the scheduling order and the select function of the concurrent events
+    void fast_forward_to_input() {
+        fast_forward(this->calendar_time(), false);
+        const auto next = internal_transition_time();
+        if (this->transition_precedes_input(next, last_transition_time_)) {
+            fast_forward(next, true);
+        }
+    }
+
+    void resume_transitions() override {
+        if (!skipping_) {
+            return;
+        }
+        fast_forward(this->calendar_time(), false);
+        schedule_internal_transition(next_internal_transition());
+    }
+
+    // the wake-up at the end of the simulation stays scheduled
+    void catch_up() override {
+        if (skipping_) {
+            fast_forward(this->calendar_time(), false);
+        }
+    }
 
     Y internal_transition() {
         // get output from current state
         const auto out = model_.out(atomic_state());
         const auto new_state = model_.delta_internal(atomic_state());
         transition_state(new_state);
+        DEVS_PROBE4(transition, probe_time(this->calendar_time()), this->name().c_str(),
+                    static_cast<int>(EventKind::INTERNAL_TRANSITION), transitions_);
         return out;
     }
 
     void external_transition(const Time& elapsed, const X& input) {
         const auto new_state = model_.delta_external(atomic_state(), elapsed, input);
         transition_state(new_state);
+        DEVS_PROBE4(transition, probe_time(this->calendar_time()), this->name().c_str(),
+                    static_cast<int>(EventKind::EXTERNAL_INPUT), transitions_);
     }
 
     void update_last_transition_time() { last_transition_time_ = this->calendar_time(); }
 
-    std::function<void()> get_internal_transition_action() {
-        return [this]() {
+    void execute_internal_transition() override {
+        if (skipping_) {
+            // woken up at the end of the simulation
+            fast_forward(this->calendar_time(), true);
+        } else {
             const auto out = internal_transition();
             this->output(out);
-            schedule_internal_transition();
-        };
+        }
+        schedule_internal_transition(next_internal_transition());
     }
 
-    void schedule_internal_transition() {
-        const auto event = Devs::_impl::Event<Time>{internal_transition_time(), get_internal_transition_action(),
-                                                    this->name(), "internal transition"};
-        cancel_internal_transition_ = event.get_cancel_callback();
-        this->schedule_event(event);
+    // rescheduling replaces the pending internal transition of the slot
+    void schedule_internal_transition(const Time& time) {
+        next_internal_transition_time_ = time;
+        internal_transition_sequence_ = this->next_event_sequence();
+        this->schedule_transition(transition_slot_, next_internal_transition_time_);
     }
 
     void dynamic_input_listener(const std::string& from, const Dynamic& input) {
-        try {
-            input_listener(input);
-        } catch (const std::bad_cast&) {
-            std::stringstream s;
-            s << "The output type of model " << from << " is not compatible with the input type of model "
-              << this->name();
-            throw std::runtime_error(s.str());
-        }
+        checked_cast([&]() { input_listener(input); },
+                     [&]() {
+                         std::stringstream s;
+                         s << "The output type of model " << from
+                           << " is not compatible with the input type of model " << this->name();
+                         return s.str();
+                     });
     }
 
     void input_listener(const X& input) {
-        if (cancel_internal_transition_) {
-            (*cancel_internal_transition_)();
+        if (skipping_) {
+            fast_forward_to_input();
         }
-
         external_transition(elapsed_since_last_transition(), input);
-        schedule_internal_transition();
+        reschedule_internal_transition();
+    }
+
+    void dynamic_parameter_listener(const Dynamic& update) {
+        checked_cast([&]() { parameter_listener(update.template value<Devs::Model::ParameterUpdate<S, Time>>()); },
+                     [&]() { return "The parameter update does not match the state type of model " + this->name(); });
+    }
+
+    // applied like an external transition, without an input
+    void parameter_listener(const Devs::Model::ParameterUpdate<S, Time>& update) {
+        if (skipping_) {
+            fast_forward_to_input();
+        }
+        transition_state(update(atomic_state(), elapsed_since_last_transition()));
+        DEVS_PROBE4(transition, probe_time(this->calendar_time()), this->name().c_str(),
+                    static_cast<int>(EventKind::PARAMETER_UPDATE), transitions_);
+        reschedule_internal_transition();
+    }
+
+    void reschedule_internal_transition() {
+        // ignored inputs (and those only consuming the elapsed time) keep the pending internal transition in place
+        const auto time = next_internal_transition();
+        if (!(time < next_internal_transition_time_) && !(next_internal_transition_time_ < time)) {
+            this->transition_kept();
+            return;
+        }
+        // a passive model has no pending internal transition to cancel
+        if (next_internal_transition_time_ < TournamentTree<Time>::NEVER) {
+            DEVS_PROBE3(event__cancel, probe_time(next_internal_transition_time_), this->name().c_str(),
+                        internal_transition_sequence_);
+        }
+        this->transition_rescheduled();
+        schedule_internal_transition(time);
     }
 
     Time elapsed_since_last_transition() { return this->calendar_time() - last_transition_time_; }
@@ -652,25 +2825,171 @@ template <typename X, typename Y, typename S, typename Time> class AtomicImpl :
   private: // members
     Devs::Model::Atomic<X, Y, S, Time> model_;
     Time last_transition_time_;
-    std::optional<std::function<void()>> cancel_internal_transition_;
+    size_t transition_slot_;
+    size_t state_bytes_;
+    size_t peak_state_bytes_;
+    Time next_internal_transition_time_;
+    std::uint64_t transitions_;
+    Listeners<const std::string&, const Time&, const std::uint64_t&> state_hash_listeners_;
+    bool dirty_;
+    std::uint64_t internal_transition_sequence_;
+    // the internal transitions are fast-forwarded on the next input or at the end of the simulation
+    bool skipping_;
 };
 
 template <typename Time> class CompoundImpl : public IOModel<Time> {
 
   public: // ctors, dtor
-    explicit CompoundImpl(const std::string name, const Devs::Model::Compound<Time> model, Calendar<Time>* p_calendar)
+    // the components of every partition (see partitions) are scheduled on the calendar of the partition, the compound
+    // itself keeps the given calendar
+    explicit CompoundImpl(const std::string name, const Devs::Model::Compound<Time> model, Calendar<Time>* p_calendar,
+                          const std::vector<std::vector<std::string>>& partitions = {},
+                          const std::vector<Calendar<Time>*>& partition_calendars = {},
+                          const std::vector<std::string>& order = {})
         : IOModel<Time>{name, p_calendar}, select_{model.select},
-          components_{factories_to_components(model.components, p_calendar)} {
+          component_partitions_{index_partitions(partitions)}, partition_calendars_{partition_calendars},
+          partition_inputs_(partition_calendars.size()), partition_outputs_(partition_calendars.size()),
+          p_arena_{ModelArena::active() ? nullptr : std::make_unique<ModelArena>()},
+          components_{factories_to_components(model.components, model.influencers, p_calendar, order)} {
         connect_components(model.influencers);
     }
 
+  public: // static functions
+    // weakly connected components of the coupling graph between the components (sorted by name)
+    // couplings with the compound input or output do not connect components
+    static std::vector<std::vector<std::string>> partitions(const Devs::Model::Compound<Time>& model) {
+        std::map<std::string, std::string> parents{};
+        for (const auto& [name, _] : model.components) {
+            parents[name] = name;
+        }
+        const auto root = [&parents](std::string name) {
+            while (parents.at(name) != name) {
+                name = parents[name] = parents.at(parents.at(name));
+            }
+            return name;
+        };
+        for (const auto& [component, influencers] : model.influencers) {
+            for (const auto& [influencer, _] : influencers) {
+                if (component && influencer && parents.count(*component) && parents.count(*influencer)) {
+                    const auto l = root(*component);
+                    const auto r = root(*influencer);
+                    parents[std::max(l, r)] = std::min(l, r);
+                }
+            }
+        }
+        std::map<std::string, std::vector<std::string>> grouped{};
+        for (const auto& [name, _] : parents) {
+            grouped[root(name)].push_back(name);
+        }
+        std::vector<std::vector<std::string>> result{};
+        for (auto& [_, names] : grouped) {
+            result.push_back(std::move(names));
+        }
+        return result;
+    }
+
+    // reverse Cuthill-McKee order over the undirected coupling graph, coupled components end up adjacent in memory
+    static std::vector<std::string>
+    layout_order(const std::unordered_map<std::string, Devs::Model::AbstractModelFactory<Time>>& factories,
+                 const std::unordered_map<std::optional<std::string>, Devs::Model::Influencers>& model_influencers) {
+        std::map<std::string, std::vector<std::string>> neighbours{};
+        for (const auto& [name, _] : factories) {
+            neighbours[name];
+        }
+        for (const auto& [component, influencers] : model_influencers) {
+            for (const auto& [influencer, _] : influencers) {
+                // couplings with the compound itself and invalid names are left for connect_components
+                if (!component || !influencer || *component == *influencer || !neighbours.count(*component) ||
+                    !neighbours.count(*influencer)) {
+                    continue;
+                }
+                neighbours[*component].push_back(*influencer);
+                neighbours[*influencer].push_back(*component);
+            }
+        }
+        const auto lower_degree = [&neighbours](const std::string& l, const std::string& r) {
+            return std::make_pair(neighbours[l].size(), l) < std::make_pair(neighbours[r].size(), r);
+        };
+        for (auto& [_, adjacent] : neighbours) {
+            std::sort(adjacent.begin(), adjacent.end());
+            adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+            std::sort(adjacent.begin(), adjacent.end(), lower_degree);
+        }
+
+        // breadth-first from the lowest degree component of every connected part
+        std::vector<std::string> starts{};
+        for (const auto& [name, _] : neighbours) {
+            starts.push_back(name);
+        }
+        std::sort(starts.begin(), starts.end(), lower_degree);
+
+        std::vector<std::string> order{};
+        std::unordered_map<std::string, bool> visited{};
+        for (const auto& start : starts) {
+            if (visited[start]) {
+                continue;
+            }
+            visited[start] = true;
+            order.push_back(start);
+            for (size_t idx = order.size() - 1; idx < order.size(); ++idx) {
+                for (const auto& adjacent : neighbours[order[idx]]) {
+                    if (!visited[adjacent]) {
+                        visited[adjacent] = true;
+                        order.push_back(adjacent);
+                    }
+                }
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
   public: // methods
+    // scheduled inputs go directly to the calendars of the coupled partitions
+    void external_input(const Time& time, const Dynamic& value, const std::string& description) override {
+        if (partition_calendars_.empty()) {
+            IOModel<Time>::external_input(time, value, description);
+            return;
+        }
+        for (size_t idx = 0; idx < partition_calendars_.size(); ++idx) {
+            if (partition_inputs_[idx].empty()) {
+                continue;
+            }
+            auto& calendar = *partition_calendars_[idx];
+            calendar.schedule_input(time, EventKind::PARTITION_INPUT, this, {value, nullptr, idx},
+                                    calendar.intern(description));
+        }
+    }
+
+    // outputs of the partitions are collected while they run concurrently, flushing delivers them in time order
+    void flush_partition_outputs() {
+        // partitions are merged in their order, so simultaneous outputs keep a deterministic order
+        std::vector<const PartitionOutput*> outputs{};
+        for (const auto& partition : partition_outputs_) {
+            for (const auto& output : partition) {
+                outputs.push_back(std::addressof(output));
+            }
+        }
+        std::stable_sort(outputs.begin(), outputs.end(),
+                         [](const PartitionOutput* l, const PartitionOutput* r) { return l->time < r->time; });
+        for (const auto p_output : outputs) {
+            this->output(p_output->value, p_output->time);
+        }
+        for (auto& partition : partition_outputs_) {
+            partition.clear();
+        }
+    }
+
     const std::unordered_map<std::string, std::unique_ptr<IOModel<Time>>>* components() const override {
         return std::addressof(components_);
     }
 
     std::optional<Dynamic> state() const override { return {}; };
 
+    std::optional<std::type_index> input_type() const override { return std::nullopt; }
+
+    std::optional<std::type_index> output_type() const override { return std::nullopt; }
+
     const std::function<std::string(const std::vector<std::string>&)> select() const override { return select_; }
 
     void add_state_transition_listener(
@@ -680,7 +2999,53 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
         }
     }
 
+    void
+    add_state_hash_listener(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) override {
+        for (auto& [_, component] : components_) {
+            component->add_state_hash_listener(listener);
+        }
+    }
+
+  private: // types
+    struct PartitionOutput {
+        Time time;
+        Dynamic value;
+    };
+
+  private: // static functions
+    static std::unordered_map<std::string, size_t>
+    index_partitions(const std::vector<std::vector<std::string>>& partitions) {
+        std::unordered_map<std::string, size_t> index{};
+        for (size_t idx = 0; idx < partitions.size(); ++idx) {
+            for (const auto& name : partitions[idx]) {
+                index[name] = idx;
+            }
+        }
+        return index;
+    }
+
   private: // methods
+    void route_external_input(const Dynamic& value) const override {
+        if (partition_calendars_.empty()) {
+            IOModel<Time>::route_external_input(value);
+            return;
+        }
+        // inputs from the compound calendar are delivered while every partition waits at the same time
+        for (size_t idx = 0; idx < partition_calendars_.size(); ++idx) {
+            deliver_partition_input(idx, value);
+        }
+    }
+
+    void route_partition_input(const size_t idx, const Dynamic& value) const override {
+        deliver_partition_input(idx, value);
+    }
+
+    void deliver_partition_input(const size_t idx, const Dynamic& value) const {
+        for (const auto& [p_component, transformer] : partition_inputs_[idx]) {
+            p_component->direct_input(this->name(), value, transformer);
+        }
+    }
+
     void sim_started(const Listener<const std::string&, const Time&, const std::string&> listener) const override {
         for (auto& [_, component] : components_) {
             component->sim_started(listener);
@@ -691,6 +3056,39 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
             component->sim_ended(listener);
         }
     }
+    void flush_output_batches() const override {
+        for (auto& [_, component] : components_) {
+            component->flush_output_batches();
+        }
+        IOModel<Time>::flush_output_batches();
+    }
+    void catch_up() override {
+        for (auto& [_, component] : components_) {
+            component->catch_up();
+        }
+    }
+    void memory_usage(const Listener<const std::string&, const size_t&, const size_t&> listener) const override {
+        for (auto& [_, component] : components_) {
+            component->memory_usage(listener);
+        }
+    }
+    void activity(const Listener<const std::string&, const Time&, const std::uint64_t&> listener) const override {
+        for (auto& [_, component] : components_) {
+            component->activity(listener);
+        }
+    }
+    void write_checkpoint(Checkpoint<Time>& checkpoint) override {
+        this->write_sources_checkpoint(checkpoint);
+        for (auto& [_, component] : components_) {
+            component->write_checkpoint(checkpoint);
+        }
+    }
+    void restore_checkpoint(const std::vector<Checkpoint<Time>>& chain, const size_t idx) override {
+        this->restore_sources_checkpoint(chain, idx);
+        for (auto& [_, component] : components_) {
+            component->restore_checkpoint(chain, idx);
+        }
+    }
 
     IOModel<Time>* model_ref(const std::string& name) {
         auto it = components_.find(name);
@@ -718,15 +3116,29 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
             if (name == std::nullopt) {
                 throw std::runtime_error("Compound model " + this->name() + " cannot influence itself");
             }
+            const auto partition = component_partitions_.find(*name);
+            if (!partition_calendars_.empty() && partition != component_partitions_.end()) {
+                connect_component_output_listener(
+                    *name, [this, transformer, idx = partition->second](const std::string& from, const Time& time,
+                                                                         const Dynamic& value) {
+                        partition_outputs_[idx].push_back({time, this->influencer_transform(from, value, transformer)});
+                    });
+                continue;
+            }
             connect_component_output_listener(
-                *name, [this, transformer](const std::string& from, const Time&, const Dynamic& value) {
-                    this->output(this->influencer_transform(from, value, transformer));
+                *name, [this, transformer](const std::string& from, const Time& time, const Dynamic& value) {
+                    this->output(this->influencer_transform(from, value, transformer), time);
                 });
         }
     }
 
     void connect_component_to_compound_input(const IOModel<Time>* p_component,
                                              const Devs::Model::Transformer& transformer) {
+        const auto partition = component_partitions_.find(p_component->name());
+        if (!partition_calendars_.empty() && partition != component_partitions_.end()) {
+            partition_inputs_[partition->second].push_back({p_component, transformer});
+            return;
+        }
         this->add_input_listener([this, p_component, transformer](const std::string&, const Dynamic& value) {
             p_component->direct_input(this->name(), value, transformer);
         });
@@ -749,6 +3161,7 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
             if (component_name == *influencer) {
                 throw std::runtime_error("Component " + component_name + " contains a forbidden self-influence loop");
             }
+            validate_coupling_types(*influencer, p_component, transformer);
 
             connect_component_output_listener(
                 *influencer,
@@ -758,6 +3171,23 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
         }
     }
 
+    // untransformed messages have to keep their type, the per-event casts rely on it in unchecked builds
+    void validate_coupling_types(const std::string& influencer, const IOModel<Time>* p_component,
+                                 const Devs::Model::Transformer& transformer) {
+        const auto p_influencer = model_ref(influencer);
+        if (transformer || p_influencer == nullptr) {
+            return;
+        }
+        const auto output = p_influencer->output_type();
+        const auto input = p_component->input_type();
+        if (output && input && *output != *input) {
+            std::stringstream s;
+            s << "The output type of model " << influencer << " is not compatible with the input type of model "
+              << p_component->name();
+            throw std::runtime_error(s.str());
+        }
+    }
+
     void connect_components(
         const std::unordered_map<std::optional<std::string>, Devs::Model::Influencers>& model_influencers) {
         for (const auto& [component, influencers] : model_influencers) {
@@ -770,19 +3200,43 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
     }
 
     std::unordered_map<std::string, std::unique_ptr<IOModel<Time>>>
-    factories_to_components(const std::unordered_map<std::string, Devs::Model::AbstractModelFactory<Time>>& factories,
-                            Calendar<Time>* p_calendar) {
+    factories_to_components(
+        const std::unordered_map<std::string, Devs::Model::AbstractModelFactory<Time>>& factories,
+        const std::unordered_map<std::optional<std::string>, Devs::Model::Influencers>& model_influencers,
+        Calendar<Time>* p_calendar, const std::vector<std::string>& order) {
 
         if (factories.empty()) {
             throw std::runtime_error("Compound model " + this->name() + " has no components");
         }
 
+        // the outermost compound owns the arena, nested ones allocate into it as well
+        std::optional<ModelArena::Scope> scope{};
+        if (p_arena_) {
+            scope.emplace(*p_arena_);
+        }
+
+        // a layout resolved beforehand (see Devs::LayoutCache) has to list every component exactly once
+        std::vector<std::string> computed_order{};
+        const auto& layout = order.empty() ? (computed_order = layout_order(factories, model_influencers)) : order;
+        if (layout.size() != factories.size()) {
+            throw std::runtime_error("The layout does not match the components of compound model " + this->name());
+        }
+
         std::unordered_map<std::string, std::unique_ptr<IOModel<Time>>> components{};
-        for (const auto& [name, factory] : factories) {
+        for (const auto& name : layout) {
             if (name == this->name()) {
                 throw std::runtime_error("Component and compound model name collision: " + name);
             }
-            components[name] = factory(name, p_calendar);
+            const auto factory = factories.find(name);
+            if (factory == factories.end() || components.count(name)) {
+                throw std::runtime_error("The layout does not match the components of compound model " +
+                                         this->name() + ": " + name);
+            }
+            const auto partition = component_partitions_.find(name);
+            const auto p_component_calendar = !partition_calendars_.empty() && partition != component_partitions_.end()
+                                                  ? partition_calendars_[partition->second]
+                                                  : p_calendar;
+            components[name] = factory->second(name, p_component_calendar);
         }
 
         return components;
@@ -790,6 +3244,12 @@ template <typename Time> class CompoundImpl : public IOModel<Time> {
 
   private: // member
     std::function<std::string(const std::vector<std::string>&)> select_;
+    std::unordered_map<std::string, size_t> component_partitions_;
+    std::vector<Calendar<Time>*> partition_calendars_;
+    std::vector<std::vector<std::pair<const IOModel<Time>*, Devs::Model::Transformer>>> partition_inputs_;
+    std::vector<std::vector<PartitionOutput>> partition_outputs_;
+    // declared before the components, which have to be destroyed first
+    std::unique_ptr<ModelArena> p_arena_;
     std::unordered_map<std::string, std::unique_ptr<IOModel<Time>>> components_;
 };
 
@@ -806,43 +3266,181 @@ constexpr float fINF = std::numeric_limits<float>::infinity();
 constexpr double INF = std::numeric_limits<double>::infinity();
 } // namespace Const
 //----------------------------------------------------------------------------------------------------------------------
-namespace Printer {
+namespace Metrics {
 
-// this enum is a limited selection, full list here:
-// https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
-enum class TextDecoration : int {
-    NONE = 0,
-    FONT_BOLD = 1,
-    FONT_LIGHT = 2,
-    ITALIC = 3,
-    UNDERLINE = 4,
-    STRIKE = 9,
-    FG_BLACK = 30,
-    FG_RED = 31,
-    FG_GREEN = 32,
-    FG_YELLOW = 33,
-    FG_BLUE = 34,
-    FG_MAGENTA = 35,
-    FG_CYAN = 36,
-    FG_WHITE = 37,
-    FG_BRIGHT_BLACK = 90,
-    FG_BRIGHT_RED = 91,
-    FG_BRIGHT_GREEN = 92,
-    FG_BRIGHT_YELLOW = 93,
-    FG_BRIGHT_BLUE = 94,
-    FG_BRIGHT_MAGENTA = 95,
-    FG_BRIGHT_CYAN = 96,
-    FG_BRIGHT_WHITE = 97,
-    //
-    BG_BLACK = 40,
-    BG_RED = 41,
-    BG_GREEN = 42,
-    BG_YELLOW = 43,
-    BG_BLUE = 44,
-    BG_MAGENTA = 45,
-    BG_CYAN = 46,
-    BG_WHITE = 47,
-    BG_BRIGHT_BLACK = 100,
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// counters only increase during a run (rates are computed from them), gauges go up and down
+enum class SampleType { GAUGE, COUNTER };
+
+struct Sample {
+  public: // members
+    std::string name;
+    std::string help;
+    Labels labels;
+    double value;
+    SampleType type = SampleType::GAUGE;
+};
+
+template <typename Time, typename Step = std::uint64_t> struct Progress {
+  public: // methods
+    // fraction of the simulated horizon already covered
+    double horizon_ratio() const {
+        const auto horizon = end_time - start_time;
+        if (!(horizon > 0.0) || std::isinf(horizon)) {
+            return 0.0;
+        }
+        return std::clamp(static_cast<double>((time - start_time) / horizon), 0.0, 1.0);
+    }
+
+    double events_per_second() const { return wall_seconds > 0.0 ? static_cast<double>(events) / wall_seconds : 0.0; }
+
+    // estimated remaining wall time, assuming a constant simulated time rate
+    std::optional<double> eta_seconds() const {
+        const auto ratio = horizon_ratio();
+        if (ratio <= 0.0) {
+            return std::nullopt;
+        }
+        return wall_seconds * (1.0 - ratio) / ratio;
+    }
+
+  public: // members
+    Time start_time;
+    Time end_time;
+    Time time;
+    Step steps;
+    std::uint64_t events;
+    size_t pending_events;
+    double wall_seconds;
+    bool finished;
+};
+
+namespace _impl {
+inline std::string escape_label_value(const std::string& value) {
+    std::string escaped{};
+    for (const auto c : value) {
+        if (c == '\\' || c == '"') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+} // namespace _impl
+
+// Prometheus text exposition format, samples of the same name have to be adjacent
+inline std::string to_prometheus(const std::vector<Sample>& samples) {
+    std::stringstream s;
+    s << std::setprecision(std::numeric_limits<double>::max_digits10);
+    std::optional<std::string> previous{};
+    for (const auto& sample : samples) {
+        if (previous != sample.name) {
+            s << "# HELP " << sample.name << " " << sample.help << "\n";
+            s << "# TYPE " << sample.name << (sample.type == SampleType::COUNTER ? " counter\n" : " gauge\n");
+            previous = sample.name;
+        }
+        s << sample.name;
+        if (!sample.labels.empty()) {
+            s << "{";
+            for (size_t i = 0; i < sample.labels.size(); ++i) {
+                s << sample.labels[i].first << "=\"" << _impl::escape_label_value(sample.labels[i].second) << "\"";
+                if (i < sample.labels.size() - 1) {
+                    s << ",";
+                }
+            }
+            s << "}";
+        }
+        s << " ";
+        if (std::isinf(sample.value)) {
+            s << (sample.value > 0 ? "+Inf" : "-Inf");
+        } else if (std::isnan(sample.value)) {
+            s << "NaN";
+        } else {
+            s << sample.value;
+        }
+        s << "\n";
+    }
+    return s.str();
+}
+
+// node-exporter textfile collector format, written to a temporary file and renamed so that a scrape never
+// observes a partially written file
+inline void write_textfile(const std::string& path, const std::vector<Sample>& samples) {
+    const auto tmp_path = path + ".tmp";
+    {
+        std::ofstream file{tmp_path, std::ios::trunc};
+        if (!file) {
+            throw std::runtime_error("Failed to open metrics textfile: " + tmp_path);
+        }
+        file << to_prometheus(samples);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to replace metrics textfile: " + path);
+    }
+}
+
+template <typename Time, typename Step>
+std::vector<Sample> progress_samples(const std::string& model, const Progress<Time, Step>& progress) {
+    const Labels labels{{"model", model}};
+    return {
+        {"devs_simulated_time", "Current simulated time.", labels, static_cast<double>(progress.time)},
+        {"devs_simulated_end_time", "Simulated time horizon.", labels, static_cast<double>(progress.end_time)},
+        {"devs_horizon_ratio", "Fraction of the simulated horizon covered.", labels, progress.horizon_ratio()},
+        {"devs_steps", "Executed simulation steps.", labels, static_cast<double>(progress.steps), SampleType::COUNTER},
+        {"devs_events", "Executed calendar events.", labels, static_cast<double>(progress.events),
+         SampleType::COUNTER},
+        {"devs_pending_events", "Events pending in the calendar.", labels,
+         static_cast<double>(progress.pending_events)},
+        {"devs_events_per_second", "Executed events per wall second.", labels, progress.events_per_second()},
+        {"devs_wall_seconds", "Wall time since the simulation started.", labels, progress.wall_seconds},
+        {"devs_eta_seconds", "Estimated remaining wall time.", labels,
+         progress.eta_seconds().value_or(std::numeric_limits<double>::quiet_NaN())},
+        {"devs_finished", "Whether the simulation has ended.", labels, progress.finished ? 1.0 : 0.0},
+    };
+}
+} // namespace Metrics
+//----------------------------------------------------------------------------------------------------------------------
+namespace Printer {
+
+// this enum is a limited selection, full list here:
+// https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
+enum class TextDecoration : int {
+    NONE = 0,
+    FONT_BOLD = 1,
+    FONT_LIGHT = 2,
+    ITALIC = 3,
+    UNDERLINE = 4,
+    STRIKE = 9,
+    FG_BLACK = 30,
+    FG_RED = 31,
+    FG_GREEN = 32,
+    FG_YELLOW = 33,
+    FG_BLUE = 34,
+    FG_MAGENTA = 35,
+    FG_CYAN = 36,
+    FG_WHITE = 37,
+    FG_BRIGHT_BLACK = 90,
+    FG_BRIGHT_RED = 91,
+    FG_BRIGHT_GREEN = 92,
+    FG_BRIGHT_YELLOW = 93,
+    FG_BRIGHT_BLUE = 94,
+    FG_BRIGHT_MAGENTA = 95,
+    FG_BRIGHT_CYAN = 96,
+    FG_BRIGHT_WHITE = 97,
+    //
+    BG_BLACK = 40,
+    BG_RED = 41,
+    BG_GREEN = 42,
+    BG_YELLOW = 43,
+    BG_BLUE = 44,
+    BG_MAGENTA = 45,
+    BG_CYAN = 46,
+    BG_WHITE = 47,
+    BG_BRIGHT_BLACK = 100,
     BG_BRIGHT_RED = 101,
     BG_BRIGHT_GREEN = 102,
     BG_BRIGHT_YELLOW = 103,
@@ -892,11 +3490,83 @@ template <typename Time, typename Step = std::uint64_t> class Base {
     virtual void on_sim_start(const std::string&, const Time&, const std::string&) {}
     virtual void on_sim_step(const Time&, const Step&) {}
     virtual void on_sim_end(const std::string&, const Time&, const std::string&) {}
+    virtual void on_model_memory(const std::string&, const size_t&, const size_t&) {}
+    // simulator
+    virtual void on_calendar_memory(const size_t&, const size_t&) {}
+    virtual void on_sim_progress(const Devs::Metrics::Progress<Time, Step>&) {}
+    // the calendar/event hooks are only invoked for printers using them
+    virtual bool traces_events() const { return false; }
+    // periodic models only materialize their transitions for printers showing them
+    virtual bool traces_transitions() const { return false; }
 
   protected: // members
     std::ostream& s_;
 };
 
+// serializes the hooks of another printer, used when partitions of a model run concurrently
+template <typename Time, typename Step = std::uint64_t> class Synchronized : public Base<Time, Step> {
+
+  public: // ctors, dtor
+    explicit Synchronized(std::unique_ptr<Base<Time, Step>> p_printer) : p_printer_{std::move(p_printer)}, mutex_{} {}
+
+  public: // static functions
+    static std::unique_ptr<Synchronized<Time, Step>> create(std::unique_ptr<Base<Time, Step>> p_printer) {
+        return std::make_unique<Synchronized<Time, Step>>(std::move(p_printer));
+    }
+
+  public: // methods
+    // calendar/events
+    void on_time_advanced(const Time& prev, const Time& next) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_time_advanced(prev, next);
+    }
+    void on_event_scheduled(const Time& time, const Devs::_impl::Event<Time>& event) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_event_scheduled(time, event);
+    }
+    void on_executing_event_action(const Time& time, const Devs::_impl::Event<Time>& event) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_executing_event_action(time, event);
+    }
+    // model
+    void on_model_state_transition(const std::string& name, const Time& time, const std::string& prev,
+                                   const std::string& next) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_model_state_transition(name, time, prev, next);
+    }
+    void on_sim_start(const std::string& name, const Time& time, const std::string& state) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_sim_start(name, time, state);
+    }
+    void on_sim_step(const Time& time, const Step& step) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_sim_step(time, step);
+    }
+    void on_sim_end(const std::string& name, const Time& time, const std::string& state) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_sim_end(name, time, state);
+    }
+    void on_model_memory(const std::string& name, const size_t& current, const size_t& peak) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_model_memory(name, current, peak);
+    }
+    // simulator
+    void on_calendar_memory(const size_t& current, const size_t& peak) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_calendar_memory(current, peak);
+    }
+    void on_sim_progress(const Devs::Metrics::Progress<Time, Step>& progress) override {
+        std::lock_guard<std::mutex> lock{mutex_};
+        p_printer_->on_sim_progress(progress);
+    }
+    bool traces_events() const override { return p_printer_->traces_events(); }
+    bool traces_transitions() const override { return p_printer_->traces_transitions(); }
+
+  private: // members
+    std::unique_ptr<Base<Time, Step>> p_printer_;
+    std::mutex mutex_;
+};
+
 template <typename Time, typename Step = std::uint64_t> class PlainVerbose : public Base<Time, Step> {
 
   public: // ctors, dtor
@@ -908,6 +3578,9 @@ template <typename Time, typename Step = std::uint64_t> class PlainVerbose : pub
     }
 
   public: // methods
+    bool traces_events() const override { return true; }
+    bool traces_transitions() const override { return true; }
+
     // calendar/event
     void on_time_advanced(const Time& prev, const Time& next) override {
         this->s_ << prefix(prev) << "Time: " << format_time(prev) << " -> " << format_time(next) << "\n";
@@ -936,6 +3609,13 @@ template <typename Time, typename Step = std::uint64_t> class PlainVerbose : pub
     void on_sim_end(const std::string& name, const Time& time, const std::string& state) override {
         this->s_ << prefix(time) << "Model " << name << " ending state: " << state << "\n";
     }
+    void on_model_memory(const std::string& name, const size_t& current, const size_t& peak) override {
+        this->s_ << "Model " << name << " memory: " << current << " B (peak: " << peak << " B)\n";
+    }
+    // simulator
+    void on_calendar_memory(const size_t& current, const size_t& peak) override {
+        this->s_ << "Calendar memory: " << current << " B (peak: " << peak << " B)\n";
+    }
 
   protected: // methods
     std::string prefix(const Time& time) {
@@ -1037,6 +3717,24 @@ template <typename Time, typename Step = std::uint64_t> class ColoredVerbose : p
         this->s_ << state << END_STYLE << "\n";
     }
 
+    void on_model_memory(const std::string& name, const size_t& current, const size_t& peak) override {
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_WHITE};
+        this->s_ << "Model " << END_STYLE;
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_GREEN};
+        this->s_ << name << END_STYLE;
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_WHITE};
+        this->s_ << " memory: " << END_STYLE;
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_CYAN};
+        this->s_ << current << " B (peak: " << peak << " B)" << END_STYLE << "\n";
+    }
+
+    void on_calendar_memory(const size_t& current, const size_t& peak) override {
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_WHITE};
+        this->s_ << "Calendar memory: " << END_STYLE;
+        this->s_ << Decorations{TextDecoration::FONT_BOLD, TextDecoration::FG_BRIGHT_CYAN};
+        this->s_ << current << " B (peak: " << peak << " B)" << END_STYLE << "\n";
+    }
+
   protected: // methods
     std::string prefix(const Time& time) {
         std::stringstream s;
@@ -1049,72 +3747,1867 @@ template <typename Time, typename Step = std::uint64_t> class ColoredVerbose : p
         return s.str();
     }
 };
+
+// silent about the simulation itself, only reports the progress published by the simulator
+template <typename Time, typename Step = std::uint64_t> class Progress : public Base<Time, Step> {
+
+  public: // ctors, dtor
+    explicit Progress(std::ostream& stream = std::cout) : Base<Time, Step>{stream} {}
+
+  public: // static functions
+    static std::unique_ptr<Progress<Time, Step>> create(std::ostream& stream = std::cout) {
+        return std::make_unique<Progress<Time, Step>>(stream);
+    }
+
+  public: // methods
+    void on_sim_progress(const Devs::Metrics::Progress<Time, Step>& progress) override {
+        std::stringstream s;
+        s << std::fixed << std::setprecision(1);
+        s << "[T = " << progress.time << "] Progress: " << progress.horizon_ratio() * 100 << " %, "
+          << progress.events_per_second() << " events/s, ";
+        if (progress.finished) {
+            s << "finished in " << progress.wall_seconds << " s";
+        } else if (const auto eta = progress.eta_seconds()) {
+            s << "ETA: " << *eta << " s";
+        } else {
+            s << "ETA: unknown";
+        }
+        this->s_ << s.str() << "\n";
+    }
+
+    void on_model_memory(const std::string& name, const size_t& current, const size_t& peak) override {
+        this->s_ << "Model " << name << " memory: " << current << " B (peak: " << peak << " B)\n";
+    }
+
+    void on_calendar_memory(const size_t& current, const size_t& peak) override {
+        this->s_ << "Calendar memory: " << current << " B (peak: " << peak << " B)\n";
+    }
+};
 } // namespace Printer
 //----------------------------------------------------------------------------------------------------------------------
-template <typename Time = double, typename Step = std::uint64_t> class Simulator {
+#if defined(__unix__)
+namespace _impl {
+// read-only mapping of a whole file, takes over the descriptor
+class MappedFile {
   public: // ctors, dtor
-    explicit Simulator(
-        const std::string model_name, const Devs::Model::AbstractModelFactory<Time> model, const Time start_time,
-        const Time end_time, const Time& time_epsilon = 0.001,
-        std::unique_ptr<Printer::Base<Time, Step>> printer = Printer::ColoredVerbose<Time, Step>::create())
-        : p_calendar_{std::make_unique<Devs::_impl::Calendar<Time>>(start_time, end_time, time_epsilon)},
-          p_printer_{std::move(printer)} {
-        setup_calendar_listeners();
-        p_model_ = model(model_name, p_calendar_.get());
-        setup_model_listeners();
+    explicit MappedFile(const int fd, const size_t size, const std::string& what, const int advice = MADV_NORMAL)
+        : p_data_{nullptr}, size_{size} {
+        if (size_ > 0) {
+            p_data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p_data_ == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Failed to memory-map " + what);
+            }
+            madvise(p_data_, size_, advice);
+        }
+        // the mapping keeps the (possibly already unlinked) file alive
+        close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (p_data_ != nullptr) {
+            munmap(p_data_, size_);
+        }
     }
 
   public: // methods
-    _impl::IOModel<Time>& model() { return *p_model_; }
+    const void* data() const { return p_data_; }
 
-    void sim_started() const {
+    size_t size() const { return size_; }
 
-        p_model_->sim_started([&](const std::string& name, const Time& time, const std::string& state) {
-            p_printer_->on_sim_start(name, time, state);
-        });
+  private: // members
+    void* p_data_;
+    size_t size_;
+};
+
+// writes all bytes, retrying short and interrupted writes
+inline bool write_all(const int fd, const void* p_data, const size_t bytes) {
+    const auto p_bytes = static_cast<const char*>(p_data);
+    for (size_t written = 0; written < bytes;) {
+        const auto result = ::write(fd, p_bytes + written, bytes - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
     }
+    return true;
+}
+} // namespace _impl
 
-    void sim_ended() {
+namespace Spill {
+namespace _impl {
+inline std::string default_directory() {
+    const auto tmpdir = std::getenv("TMPDIR");
+    return tmpdir != nullptr ? tmpdir : "/tmp";
+}
+} // namespace _impl
 
-        p_model_->sim_ended([&](const std::string& name, const Time& time, const std::string& state) {
-            p_printer_->on_sim_end(name, time, state);
-        });
+// out-of-core storage for huge numbers of far-future external inputs (e.g. trace-driven arrivals)
+// inputs are buffered, written as sorted compact runs to unlinked temporary files and merged lazily from
+// memory-mapped runs, so the calendar only ever holds the next input and the resident memory stays bounded
+template <typename T, typename Time = double> class Runs {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<Time>,
+                  "Spilled inputs are stored as raw bytes");
+
+  public: // ctors, dtor
+    explicit Runs(const size_t run_capacity = 1 << 20, const std::string directory = _impl::default_directory())
+        : run_capacity_{std::max<size_t>(run_capacity, 1)}, directory_{directory}, buffer_{}, runs_{}, size_{0} {}
+
+  public: // methods
+    void add(const Time time, const T value) {
+        buffer_.push_back({time, value});
+        ++size_;
+        if (buffer_.size() >= run_capacity_) {
+            spill();
+        }
     }
 
-    void run() {
-        Step step{1};
-        sim_started();
-        while (p_calendar_->execute_next(p_model_->select())) {
-            p_printer_->on_sim_step(p_calendar_->time(), step);
-            ++step;
+    size_t size() const { return size_; }
+
+    size_t spilled_runs() const { return runs_.size(); }
+
+    // the merged inputs in time order, equal times keep the insertion order (earlier runs first)
+    // the sources share the spilled runs, each one merges them independently, O(log runs) per input
+    Devs::Model::InputSource<Time> source() {
+        spill();
+        const auto runs = std::make_shared<const std::vector<Run>>(runs_);
+        std::vector<Cursor> cursors{};
+        for (size_t idx = 0; idx < runs->size(); ++idx) {
+            cursors.push_back({(*runs)[idx].at(0).time, idx, 0});
         }
-        sim_ended();
+        return [runs, cursors = std::priority_queue<Cursor, std::vector<Cursor>, std::greater<>>{
+                                    std::greater<>{}, std::move(cursors)}]() mutable
+               -> std::optional<Devs::Model::Input<Time>> {
+            if (cursors.empty()) {
+                return std::nullopt;
+            }
+            auto cursor = cursors.top();
+            cursors.pop();
+            const auto& run = (*runs)[cursor.run];
+            const auto record = run.at(cursor.record);
+            if (++cursor.record < run.size) {
+                cursor.time = run.at(cursor.record).time;
+                cursors.push(cursor);
+            }
+            return Devs::Model::Input<Time>{record.time, record.value};
+        };
     }
 
+  private: // types
+    struct Record {
+        Time time;
+        T value;
+    };
+
+    struct Run {
+      public: // methods
+        const Record& at(const size_t idx) const { return static_cast<const Record*>(p_file->data())[idx]; }
+
+      public: // members
+        std::shared_ptr<const Devs::_impl::MappedFile> p_file;
+        size_t size;
+    };
+
+    // next record of a run in the merge
+    struct Cursor {
+      public: // methods
+        bool operator>(const Cursor& other) const {
+            return other.time < time || (!(time < other.time) && run > other.run);
+        }
+
+      public: // members
+        Time time;
+        size_t run;
+        size_t record;
+    };
+
   private: // methods
-    void setup_calendar_listeners() {
-        p_calendar_->add_time_advanced_listener(
-            [this](const Time& prev, const Time& next) { p_printer_->on_time_advanced(prev, next); });
-        p_calendar_->add_event_scheduled_listener([this](const Time& time, const Devs::_impl::Event<Time>& event) {
-            p_printer_->on_event_scheduled(time, event);
-        });
-        p_calendar_->add_executing_event_action_listener(
-            [this](const Time& time, const Devs::_impl::Event<Time>& event) {
-                p_printer_->on_executing_event_action(time, event);
-            });
-    }
+    void spill() {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::stable_sort(buffer_.begin(), buffer_.end(),
+                         [](const Record& l, const Record& r) { return l.time < r.time; });
 
-    void setup_model_listeners() {
-        p_model_->add_state_transition_listener(
-            [this](const std::string& name, const Time& time, const std::string& prev, const std::string& next) {
-                p_printer_->on_model_state_transition(name, time, prev, next);
-            });
+        auto path = directory_ + "/devs-spill-XXXXXX";
+        const auto fd = mkstemp(path.data());
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create a spill file in " + directory_);
+        }
+        unlink(path.c_str());
+
+        const auto bytes = buffer_.size() * sizeof(Record);
+        if (!Devs::_impl::write_all(fd, buffer_.data(), bytes)) {
+            close(fd);
+            throw std::runtime_error("Failed to write a spilled event run");
+        }
+
+        // sequential merge access
+        runs_.push_back({std::make_shared<const Devs::_impl::MappedFile>(fd, bytes, "a spilled event run",
+                                                                         MADV_SEQUENTIAL),
+                         buffer_.size()});
+        buffer_.clear();
+        buffer_.shrink_to_fit();
     }
 
   private: // members
-    std::unique_ptr<Devs::_impl::Calendar<Time>> p_calendar_;
-    std::unique_ptr<Devs::Printer::Base<Time, Step>> p_printer_;
-    std::unique_ptr<Devs::_impl::IOModel<Time>> p_model_;
+    size_t run_capacity_;
+    std::string directory_;
+    std::vector<Record> buffer_;
+    std::vector<Run> runs_;
+    size_t size_;
+};
+} // namespace Spill
+#endif
+//----------------------------------------------------------------------------------------------------------------------
+// resolving the structure of large (e.g. generated) compound models may take longer than the short simulations run
+// with them, a binary layout cache keeps it between the processes
+// it is not a prebuilt model: the components are closures and are built from the model (with their initial states)
+// on every start, the cache holds only what is derived from the component names and couplings: the memory layout order
+// of the components and their partitions (see Simulator)
+namespace LayoutCache {
+
+struct Layout {
+  public: // members
+    std::vector<std::string> order;
+    std::vector<std::vector<std::string>> partitions;
+    // read from a cache file instead of resolved
+    bool cached = false;
+};
+
+namespace _impl {
+constexpr std::array<char, 8> MAGIC{'D', 'E', 'V', 'S', 'I', 'M', 'G', '1'};
+constexpr std::uint32_t NO_PARTITION = std::numeric_limits<std::uint32_t>::max();
+
+// relocatable, the entries follow the header in the layout order and reference the name table following them by
+// offsets
+struct Header {
+    std::array<char, 8> magic;
+    std::uint64_t hash;
+    std::uint64_t components;
+    std::uint64_t partitions;
+    std::uint64_t name_bytes;
+};
+
+struct Entry {
+    std::uint64_t name_offset;
+    std::uint32_t name_size;
+    std::uint32_t partition;
 };
+
+// the size keeps consecutive names apart, the compound itself (no name) gets a size no name has
+inline std::uint64_t name_hash(const std::optional<std::string>& name, const std::uint64_t hash) {
+    if (!name) {
+        return Devs::Traits::fnv1a(std::numeric_limits<size_t>::max(), hash);
+    }
+    return Devs::Traits::fnv1a(*name, Devs::Traits::fnv1a(name->size(), hash));
+}
+} // namespace _impl
+
+// order-independent hash of the component names and of the couplings, the only inputs of the layout
+template <typename Time> std::uint64_t description_hash(const Devs::Model::Compound<Time>& model) {
+    auto hash = Devs::Traits::mix(model.components.size());
+    for (const auto& [name, _] : model.components) {
+        hash += Devs::Traits::mix(_impl::name_hash(name, Devs::Traits::FNV_OFFSET));
+    }
+    for (const auto& [component, influencers] : model.influencers) {
+        const auto component_hash = _impl::name_hash(component, Devs::Traits::FNV_OFFSET);
+        for (const auto& [influencer, _] : influencers) {
+            hash += Devs::Traits::mix(_impl::name_hash(influencer, component_hash));
+        }
+    }
+    return hash;
+}
+
+template <typename Time> Layout resolve(const Devs::Model::Compound<Time>& model) {
+    return {Devs::_impl::CompoundImpl<Time>::layout_order(model.components, model.influencers),
+            Devs::_impl::CompoundImpl<Time>::partitions(model)};
+}
+
+#if defined(__unix__)
+// written to a temporary file renamed over the path, so that concurrent runs never read a partial cache file
+inline void write(const std::string& path, const Layout& layout, const std::uint64_t hash) {
+    std::unordered_map<std::string, std::uint32_t> partition_of{};
+    for (size_t idx = 0; idx < layout.partitions.size(); ++idx) {
+        for (const auto& name : layout.partitions[idx]) {
+            partition_of[name] = static_cast<std::uint32_t>(idx);
+        }
+    }
+    std::vector<_impl::Entry> entries{};
+    std::string names{};
+    for (const auto& name : layout.order) {
+        const auto partition = partition_of.find(name);
+        entries.push_back({names.size(), static_cast<std::uint32_t>(name.size()),
+                           partition != partition_of.end() ? partition->second : _impl::NO_PARTITION});
+        names += name;
+    }
+    const _impl::Header header{_impl::MAGIC, hash, entries.size(), layout.partitions.size(), names.size()};
+
+    auto temporary = path + ".XXXXXX";
+    const auto fd = mkstemp(temporary.data());
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create a layout cache file next to " + path);
+    }
+    const std::vector<std::pair<const char*, size_t>> parts{
+        {reinterpret_cast<const char*>(std::addressof(header)), sizeof(header)},
+        {reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(_impl::Entry)},
+        {names.data(), names.size()}};
+    for (const auto& [p_data, bytes] : parts) {
+        if (!Devs::_impl::write_all(fd, p_data, bytes)) {
+            close(fd);
+            unlink(temporary.c_str());
+            throw std::runtime_error("Failed to write the layout cache file " + path);
+        }
+    }
+    close(fd);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        throw std::runtime_error("Failed to replace the layout cache file " + path);
+    }
+}
+
+// nothing when the cache file is missing, malformed or describes another model
+inline std::optional<Layout> read(const std::string& path, const std::uint64_t hash) {
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(_impl::Header)) {
+        close(fd);
+        return std::nullopt;
+    }
+    const Devs::_impl::MappedFile file{fd, static_cast<size_t>(status.st_size), "the layout cache file " + path,
+                                       MADV_SEQUENTIAL};
+    const auto p_bytes = static_cast<const char*>(file.data());
+    const auto& header = *reinterpret_cast<const _impl::Header*>(p_bytes);
+    const auto entries_bytes = file.size() - sizeof(_impl::Header);
+    if (header.magic != _impl::MAGIC || header.hash != hash ||
+        header.components > entries_bytes / sizeof(_impl::Entry) ||
+        header.components * sizeof(_impl::Entry) + header.name_bytes != entries_bytes ||
+        header.partitions > header.components) {
+        // a partition holds at least one component, which also bounds the allocation below
+        return std::nullopt;
+    }
+    const auto p_entries = reinterpret_cast<const _impl::Entry*>(p_bytes + sizeof(_impl::Header));
+    const auto p_names = p_bytes + sizeof(_impl::Header) + header.components * sizeof(_impl::Entry);
+
+    Layout layout{{}, std::vector<std::vector<std::string>>(header.partitions), true};
+    layout.order.reserve(header.components);
+    for (size_t idx = 0; idx < header.components; ++idx) {
+        const auto& entry = p_entries[idx];
+        if (entry.name_offset > header.name_bytes || entry.name_size > header.name_bytes - entry.name_offset ||
+            (entry.partition != _impl::NO_PARTITION && entry.partition >= header.partitions)) {
+            return std::nullopt;
+        }
+        layout.order.emplace_back(p_names + entry.name_offset, entry.name_size);
+        if (entry.partition != _impl::NO_PARTITION) {
+            layout.partitions[entry.partition].push_back(layout.order.back());
+        }
+    }
+    return layout;
+}
+
+// the layout cached at the path when it describes the model, otherwise the model is resolved and the cache file
+// (re)written for the next runs
+template <typename Time> Layout cached(const std::string& path, const Devs::Model::Compound<Time>& model) {
+    const auto hash = description_hash(model);
+    if (auto layout = read(path, hash)) {
+        return std::move(*layout);
+    }
+    auto layout = resolve(model);
+    write(path, layout, hash);
+    return layout;
+}
+#endif
+} // namespace LayoutCache
+//----------------------------------------------------------------------------------------------------------------------
+namespace Introspection {
+
+// set from the signal handler, only ever read and cleared between simulation steps
+inline volatile std::sig_atomic_t requested = 0;
+
+namespace _impl {
+extern "C" inline void request_handler(int) { requested = 1; }
+} // namespace _impl
+
+// async-signal-safe trigger, e.g. kill -USR1 <pid> dumps the state of a running simulation
+inline void install_signal_handler(const int signal = SIGUSR1) {
+    if (std::signal(signal, _impl::request_handler) == SIG_ERR) {
+        throw std::runtime_error("Failed to install the introspection signal handler");
+    }
+}
+
+inline bool consume_request() {
+    if (requested == 0) {
+        return false;
+    }
+    requested = 0;
+    return true;
+}
+} // namespace Introspection
+//----------------------------------------------------------------------------------------------------------------------
+namespace Divergence {
+
+struct Record {
+  public: // members
+    std::uint64_t step;
+    double time;
+    std::uint64_t transitions;
+    std::uint64_t digest;
+};
+
+// rolling hash of every model transition
+// each model keeps its own chain over (time, name, state hash), the chains are combined order-independently so that
+// engines interleaving independent models differently still produce the same digest
+class Digest {
+  public: // ctors, dtor
+    Digest() : chains_{}, digest_{0}, transitions_{0} {}
+
+  public: // methods
+    void add(const std::string& model, const double time, const std::uint64_t state_hash) {
+        auto& chain = chains_.try_emplace(model, Devs::Traits::fnv1a(model)).first->second;
+        digest_ ^= Devs::Traits::mix(chain);
+        chain = Devs::Traits::fnv1a(state_hash, Devs::Traits::fnv1a(time, chain));
+        digest_ ^= Devs::Traits::mix(chain);
+        ++transitions_;
+    }
+
+    std::uint64_t value() const { return digest_; }
+    std::uint64_t transitions() const { return transitions_; }
+
+  private: // members
+    std::unordered_map<std::string, std::uint64_t> chains_;
+    std::uint64_t digest_;
+    std::uint64_t transitions_;
+};
+
+constexpr auto HEADER = "# devs state hashes v1: step time transitions digest";
+
+inline void write_record(std::ostream& os, const Record& record) {
+    os << record.step << " " << std::setprecision(std::numeric_limits<double>::max_digits10) << record.time << " "
+       << record.transitions << " " << std::hex << record.digest << std::dec << "\n";
+}
+
+inline std::vector<Record> read_records(const std::string& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error("Failed to open state hash file: " + path);
+    }
+    std::string line;
+    if (!std::getline(file, line) || line != HEADER) {
+        throw std::runtime_error("Invalid state hash file header: " + path);
+    }
+    std::vector<Record> records{};
+    while (std::getline(file, line)) {
+        std::stringstream s{line};
+        Record record{};
+        if (!(s >> record.step >> record.time >> record.transitions >> std::hex >> record.digest)) {
+            throw std::runtime_error("Invalid state hash record in " + path + ": " + line);
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+struct Divergence {
+  public: // methods
+    std::string to_string() const {
+        std::stringstream s;
+        s << std::setprecision(std::numeric_limits<double>::max_digits10);
+        if (!left || !right) {
+            s << "Runs diverge in length after " << (last_match ? last_match->step : 0)
+              << " steps, one of the runs has no further records";
+            return s.str();
+        }
+        if (exact()) {
+            s << "Runs diverge at step " << left->step << " (T = " << left->time << " / " << right->time
+              << "), transitions: " << left->transitions << " / " << right->transitions
+              << ", this is the first divergent event";
+            return s.str();
+        }
+        s << "Runs diverge between step " << (last_match ? last_match->step : 0) << " (T = "
+          << (last_match ? last_match->time : 0.0) << ") and step " << left->step << " (T = " << left->time
+          << " / " << right->time << "), transitions: " << left->transitions << " / " << right->transitions
+          << ", the records are " << left->step - (last_match ? last_match->step : 0)
+          << " steps apart so only the window is known, record every step in this window to find the exact event";
+        return s.str();
+    }
+
+    // consecutive records (recorded every step) locate the divergent event itself, otherwise only its window
+    bool exact() const {
+        return left && right && left->step == right->step && left->step == (last_match ? last_match->step : 0) + 1;
+    }
+
+  public: // members
+    std::optional<Record> last_match;
+    std::optional<Record> left;
+    std::optional<Record> right;
+};
+
+// compares two runs recorded with the same step interval, returns nothing when they match
+inline std::optional<Divergence> compare(const std::vector<Record>& left, const std::vector<Record>& right) {
+    std::optional<Record> last_match{};
+    for (size_t i = 0; i < std::min(left.size(), right.size()); ++i) {
+        const auto& l = left[i];
+        const auto& r = right[i];
+        if (l.step != r.step || l.time != r.time || l.transitions != r.transitions || l.digest != r.digest) {
+            return Divergence{last_match, l, r};
+        }
+        last_match = l;
+    }
+    if (left.size() != right.size()) {
+        const auto idx = std::min(left.size(), right.size());
+        return Divergence{last_match, idx < left.size() ? std::optional<Record>{left[idx]} : std::nullopt,
+                          idx < right.size() ? std::optional<Record>{right[idx]} : std::nullopt};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Divergence> compare(const std::string& left_path, const std::string& right_path) {
+    return compare(read_records(left_path), read_records(right_path));
+}
+} // namespace Divergence
+//----------------------------------------------------------------------------------------------------------------------
+namespace Parallel {
+
+struct Worker {
+  public: // members
+    unsigned cpu;
+    int socket;
+};
+
+namespace _impl {
+inline std::optional<int> read_int(const std::string& path) {
+    std::ifstream file{path};
+    int value{};
+    if (file >> value) {
+        return value;
+    }
+    return std::nullopt;
+}
+
+inline int cpu_socket(const unsigned cpu) {
+    // sysfs is the only dependency-free source of the package topology, assume a single socket elsewhere
+    return read_int("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/physical_package_id")
+        .value_or(0);
+}
+
+inline std::vector<unsigned> available_cpus() {
+    std::vector<unsigned> cpus{};
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+inline bool pin_current_thread(const unsigned cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+inline size_t& current_worker_idx() {
+    static thread_local size_t idx = std::numeric_limits<size_t>::max();
+    return idx;
+}
+} // namespace _impl
+
+// spread workers over sockets in a round-robin fashion so that a partially used pool still loads every socket
+inline std::vector<Worker> worker_layout(const size_t threads) {
+    std::map<int, std::vector<unsigned>> sockets{};
+    for (const auto cpu : _impl::available_cpus()) {
+        sockets[_impl::cpu_socket(cpu)].push_back(cpu);
+    }
+
+    std::vector<Worker> interleaved{};
+    size_t round{0};
+    while (interleaved.size() < threads) {
+        bool any{false};
+        for (const auto& [socket, cpus] : sockets) {
+            if (round < cpus.size() && interleaved.size() < threads) {
+                interleaved.push_back({cpus[round], socket});
+                any = true;
+            }
+        }
+        // more threads than cpus, oversubscribe from the beginning
+        round = any ? round + 1 : 0;
+    }
+    return interleaved;
+}
+
+class ThreadPool {
+  public: // ctors, dtor
+    explicit ThreadPool(const size_t threads = std::max(1u, std::thread::hardware_concurrency()), const bool pin = true)
+        : workers_{worker_layout(std::max<size_t>(threads, 1))}, pinned_{pin}, threads_{}, tasks_{}, mutex_{},
+          condition_{}, stopping_{false} {
+        for (size_t idx = 0; idx < workers_.size(); ++idx) {
+            threads_.emplace_back([this, idx]() { work(idx); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+  public: // static functions
+    // index of the pool worker running the calling thread, if any
+    static std::optional<size_t> current_worker() {
+        const auto idx = _impl::current_worker_idx();
+        if (idx == std::numeric_limits<size_t>::max()) {
+            return std::nullopt;
+        }
+        return idx;
+    }
+
+  public: // methods
+    template <typename F> std::future<std::invoke_result_t<F>> submit(F task) {
+        using R = std::invoke_result_t<F>;
+        auto p_task = std::make_shared<std::packaged_task<R()>>(std::move(task));
+        auto future = p_task->get_future();
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            tasks_.push([p_task]() { (*p_task)(); });
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+    size_t size() const { return workers_.size(); }
+
+    const std::vector<Worker>& workers() const { return workers_; }
+
+    bool pinned() const { return pinned_; }
+
+  private: // methods
+    void work(const size_t idx) {
+        _impl::current_worker_idx() = idx;
+        if (pinned_) {
+            _impl::pin_current_thread(workers_[idx].cpu);
+        }
+
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+  private: // members
+    std::vector<Worker> workers_;
+    bool pinned_;
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+};
+
+} // namespace Parallel
+//----------------------------------------------------------------------------------------------------------------------
+// how a simulator runs a compound model
+// SEQUENTIAL: every model on a single calendar
+// PARTITIONED: the components of the compound which are not coupled to each other (directly or indirectly) form
+// partitions, each partition runs on its own calendar and thread and the outputs are merged in time order
+// the listeners of the components then run on the worker threads, simultaneous events of different partitions are not
+// ordered by the select function and state hashes, checkpoints, replays and resets are not available
+enum class Execution { SEQUENTIAL, PARTITIONED };
+
+template <typename Time = double, typename Step = std::uint64_t> class Simulator {
+  public: // ctors, dtor
+    explicit Simulator(
+        const std::string model_name, const Devs::Model::AbstractModelFactory<Time> model, const Time start_time,
+        const Time end_time, const Time& time_epsilon = 0.001,
+        std::unique_ptr<Printer::Base<Time, Step>> printer = Printer::ColoredVerbose<Time, Step>::create())
+        : Simulator{Members{}, model_name, start_time, end_time, time_epsilon, std::move(printer)} {
+        p_model_ = model(model_name, p_calendar_.get());
+        setup_model_listeners();
+    }
+
+    // the compound runs on a single calendar unless PARTITIONED execution is requested, see Execution
+    explicit Simulator(
+        const std::string model_name, const Devs::Model::Compound<Time> model, const Time start_time,
+        const Time end_time, const Time& time_epsilon = 0.001,
+        std::unique_ptr<Printer::Base<Time, Step>> printer = Printer::ColoredVerbose<Time, Step>::create(),
+        const Execution execution = Execution::SEQUENTIAL)
+        : Simulator{model_name, model, Devs::LayoutCache::resolve(model), start_time, end_time, time_epsilon,
+                    std::move(printer), execution} {}
+
+    // the layout resolved beforehand, e.g. read from a layout cache (see Devs::LayoutCache::cached)
+    explicit Simulator(
+        const std::string model_name, const Devs::Model::Compound<Time> model, const Devs::LayoutCache::Layout& layout,
+        const Time start_time, const Time end_time, const Time& time_epsilon = 0.001,
+        std::unique_ptr<Printer::Base<Time, Step>> printer = Printer::ColoredVerbose<Time, Step>::create(),
+        const Execution execution = Execution::SEQUENTIAL)
+        : Simulator{Members{}, model_name, start_time, end_time, time_epsilon, std::move(printer)} {
+        const auto& partitions = layout.partitions;
+        if (execution == Execution::SEQUENTIAL || partitions.size() < 2) {
+            p_model_ = std::make_unique<Devs::_impl::CompoundImpl<Time>>(model_name, model, p_calendar_.get(),
+                                                                         std::vector<std::vector<std::string>>{},
+                                                                         std::vector<Devs::_impl::Calendar<Time>*>{},
+                                                                         layout.order);
+            setup_model_listeners();
+            return;
+        }
+        std::vector<Devs::_impl::Calendar<Time>*> calendars{};
+        for (size_t idx = 0; idx < partitions.size(); ++idx) {
+            partition_calendars_.push_back(
+                std::make_unique<Devs::_impl::Calendar<Time>>(start_time, end_time, time_epsilon));
+            calendars.push_back(partition_calendars_.back().get());
+            setup_calendar_listeners(*calendars.back());
+        }
+        p_printer_ = Printer::Synchronized<Time, Step>::create(std::move(p_printer_));
+        trace_events();
+        auto p_compound = std::make_unique<Devs::_impl::CompoundImpl<Time>>(model_name, model, p_calendar_.get(),
+                                                                            partitions, calendars, layout.order);
+        p_partitioned_ = p_compound.get();
+        p_model_ = std::move(p_compound);
+        setup_model_listeners();
+    }
+
+  private: // ctors, dtor
+    struct Members {};
+
+    explicit Simulator(Members, const std::string model_name, const Time start_time, const Time end_time,
+                       const Time& time_epsilon, std::unique_ptr<Printer::Base<Time, Step>> printer)
+        : p_calendar_{std::make_unique<Devs::_impl::Calendar<Time>>(start_time, end_time, time_epsilon)},
+          p_printer_{std::move(printer)}, model_name_{model_name}, start_time_{start_time}, steps_{0},
+          progress_interval_{}, wall_budget_{}, metrics_textfile_{}, budget_exceeded_{false}, wall_start_{},
+          last_progress_{}, p_introspection_stream_{nullptr}, p_hash_file_{}, hash_interval_{1}, digest_{},
+          checkpoints_{}, checkpoint_interval_{}, next_checkpoint_time_{}, replay_base_{}, reset_enabled_{false},
+          initial_state_{}, parameter_schedule_{}, parameter_schedule_pending_{false}, partition_calendars_{},
+          p_partitioned_{nullptr}, p_pool_{} {
+        setup_calendar_listeners(*p_calendar_);
+        trace_events();
+    }
+
+  public: // methods
+    _impl::IOModel<Time>& model() { return *p_model_; }
+
+    // number of independently running partitions, 0 when the model runs on a single calendar
+    size_t partitions() const { return partition_calendars_.size(); }
+
+    const Time& time() const { return p_calendar_->time(); }
+
+    // publish progress to the printer (and the metrics textfile) every interval of wall time
+    void set_progress_interval(const std::chrono::duration<double> interval) { progress_interval_ = interval; }
+
+    // stop the run once the wall time exceeds the budget, the models keep their partial state
+    void set_wall_budget(const std::chrono::duration<double> budget) {
+        if (!(budget.count() > 0.0)) {
+            throw std::runtime_error("The wall budget of a simulation should be positive");
+        }
+        wall_budget_ = budget;
+    }
+
+    // node-exporter textfile collector target, rewritten with every progress report
+    void set_metrics_textfile(const std::string& path) { metrics_textfile_ = path; }
+
+    bool budget_exceeded() const { return budget_exceeded_; }
+
+    Devs::Metrics::Progress<Time, Step> progress(const bool finished = false) const {
+        const std::chrono::duration<double> wall = Clock::now() - wall_start_;
+        std::uint64_t events{};
+        size_t pending_events{};
+        for (const auto p_calendar : calendars()) {
+            events += p_calendar->executed_events();
+            pending_events += p_calendar->pending_events();
+        }
+        return {start_time_, p_calendar_->end_time(), p_calendar_->time(), steps_, events, pending_events, wall.count(),
+                finished};
+    }
+
+    // dump a bounded view of the pending events, the engine progress and the most active models
+    // does not modify the simulated trajectory (skipping models only catch up), cost is independent of the calendar
+    // size apart from the model count
+    void introspect(std::ostream& os, const size_t events = 10, const size_t models = 10) {
+        struct Activity {
+            std::string name;
+            Time next;
+            std::uint64_t transitions;
+        };
+
+        p_model_->catch_up();
+        std::vector<Activity> activities{};
+        p_model_->activity([&](const std::string& name, const Time& next, const std::uint64_t& transitions) {
+            activities.push_back({name, next, transitions});
+        });
+        const auto hottest = std::min(models, activities.size());
+        std::partial_sort(activities.begin(), activities.begin() + hottest, activities.end(),
+                          [](const Activity& l, const Activity& r) { return l.transitions > r.transitions; });
+
+        const auto current = progress();
+        std::stringstream s;
+        s << "Introspection of " << model_name_ << " at T = " << current.time << " (step " << current.steps
+          << "):\n";
+        s << "Progress: " << current.horizon_ratio() * 100 << " %, " << current.events << " events, "
+          << current.events_per_second() << " events/s, " << current.pending_events << " pending events ("
+          << event_set_kind_to_str(p_calendar_->event_set_kind()) << ", "
+          << p_calendar_->event_set_migrations() << " migrations)\n";
+        s << "Next pending events:\n";
+        std::vector<Devs::_impl::Event<Time>> next_events{};
+        for (const auto p_calendar : calendars()) {
+            const auto calendar_events = p_calendar->peek(events);
+            next_events.insert(next_events.end(), calendar_events.begin(), calendar_events.end());
+        }
+        // the sequences of different calendars are unrelated, order by time only
+        std::stable_sort(next_events.begin(), next_events.end(),
+                         [](const auto& l, const auto& r) { return l.time() < r.time(); });
+        next_events.erase(next_events.begin() + static_cast<std::ptrdiff_t>(std::min(events, next_events.size())),
+                          next_events.end());
+        for (const auto& event : next_events) {
+            s << "  " << event.to_string() << "\n";
+        }
+        s << "Most active models:\n";
+        for (size_t i = 0; i < hottest; ++i) {
+            s << "  " << activities[i].name << ": transitions = " << activities[i].transitions
+              << ", next internal transition = " << activities[i].next << "\n";
+        }
+        os << s.str() << std::flush;
+    }
+
+    // dump the introspection view whenever the signal is received, checked between steps
+    void enable_introspection(std::ostream& os = std::cerr, const int signal = SIGUSR1) {
+        Devs::Introspection::install_signal_handler(signal);
+        p_introspection_stream_ = std::addressof(os);
+    }
+
+    // opt-in divergence checking, a record of the rolling state hash is written every `every` steps and at the end
+    // compare two recordings with Devs::Divergence::compare
+    void record_state_hashes(const std::string path, const Step every = 1) {
+        if (every == 0) {
+            throw std::runtime_error("State hash interval must be positive");
+        }
+        p_hash_file_ = std::make_unique<std::ofstream>(path, std::ios::trunc);
+        if (!*p_hash_file_) {
+            throw std::runtime_error("Failed to open state hash file: " + path);
+        }
+        require_single_calendar("State hash recording");
+        *p_hash_file_ << Devs::Divergence::HEADER << "\n";
+        hash_interval_ = every;
+        p_model_->add_state_hash_listener([this](const std::string& name, const Time& time, const std::uint64_t& hash) {
+            digest_.add(name, static_cast<double>(time), hash);
+        });
+    }
+
+    // store the models and pending events, the first checkpoint is full, the following ones only contain the models
+    // that transitioned and the input events scheduled or removed since the previous one
+    size_t checkpoint() {
+        require_single_calendar("Checkpointing");
+        end_replay();
+        Devs::_impl::Checkpoint<Time> checkpoint{checkpoints_.empty(), {}, steps_, 0, 0, {}, {}, {}, {}};
+        if (checkpoint.full) {
+            p_calendar_->track_changes();
+        }
+        p_calendar_->write_checkpoint(checkpoint);
+        p_model_->write_checkpoint(checkpoint);
+        checkpoints_.push_back(std::move(checkpoint));
+        return checkpoints_.size() - 1;
+    }
+
+    // return to a checkpoint, the later checkpoints are discarded and run() continues from there
+    void restore(const size_t idx) {
+        restore_state(idx);
+        replay_base_ = idx;
+        end_replay();
+    }
+
+    // time travel: restores the latest checkpoint before from and replays the events up to to, only the events within
+    // [from, to] are reported to the printer, output listeners see the replayed outputs again
+    // the checkpoints are kept for further replays until the simulation continues by run() or checkpoint()
+    void replay(const Time& from, const Time& to, std::unique_ptr<Printer::Base<Time, Step>> printer) {
+        require_single_calendar("Replaying");
+        if (checkpoints_.empty()) {
+            throw std::runtime_error("Replaying requires a checkpoint, see set_checkpoint_interval: " + model_name_);
+        }
+        if (to < from) {
+            throw std::runtime_error("Replay window ends before it starts: " + model_name_);
+        }
+        size_t idx{0};
+        while (idx + 1 < checkpoints_.size() && !(from < checkpoints_[idx + 1].time)) {
+            ++idx;
+        }
+        restore_state(idx);
+        replay_base_ = idx;
+
+        auto p_previous = std::exchange(p_printer_, Printer::Base<Time, Step>::create());
+        trace_events();
+        try {
+            const auto select = p_model_->select();
+            bool window{false};
+            for (Step step{steps_ + 1};; ++step) {
+                const auto next = p_calendar_->next_event_time();
+                if (!window && (!next || !(*next < from))) {
+                    // skipping models fast-forward to the window start once traced, their transitions follow
+                    p_calendar_->advance_to(from);
+                    p_printer_ = std::move(printer);
+                    trace_events();
+                    window = true;
+                    continue;
+                }
+                if (!next || to < *next) {
+                    break;
+                }
+                if (!p_calendar_->execute_next(select)) {
+                    break;
+                }
+                p_printer_->on_sim_step(p_calendar_->time(), step);
+                steps_ = step;
+            }
+        } catch (...) {
+            p_printer_ = std::move(p_previous);
+            trace_events();
+            throw;
+        }
+        p_printer_ = std::move(p_previous);
+        trace_events();
+    }
+
+    // pins the pending event structure, by default the calendar migrates between them following its cost model
+    void set_event_set(const EventSetKind kind, const bool adaptive = false) {
+        for (const auto p_calendar : calendars()) {
+            p_calendar->set_event_set(kind, adaptive);
+        }
+    }
+
+    // take a checkpoint whenever the simulated time advances by the interval
+    void set_checkpoint_interval(const Time interval) {
+        require_single_calendar("Checkpointing");
+        checkpoint_interval_ = interval;
+    }
+
+    size_t checkpoint_count() const { return checkpoints_.size(); }
+
+    // parameter updates applied during the simulation, scheduled by the next run() and again after every reset()
+    void set_parameter_schedule(const Devs::Model::ParameterSchedule<Time>& schedule) {
+        parameter_schedule_.emplace(schedule);
+        parameter_schedule_pending_ = true;
+    }
+
+    // the first run() keeps a full snapshot of the models and pending events for reset()
+    void enable_reset() {
+        require_single_calendar("Resetting");
+        if (steps_ != 0 || !checkpoints_.empty()) {
+            throw std::runtime_error("Resetting has to be enabled before the first run: " + model_name_);
+        }
+        reset_enabled_ = true;
+    }
+
+    // returns the models and pending events to the state before the first run(), dropping the checkpoints, so that
+    // sweeps (e.g. over parameter schedules) reuse the built model
+    void reset() {
+        require_single_calendar("Resetting");
+        if (initial_state_.empty()) {
+            throw std::runtime_error("Resetting requires enable_reset() before the first run: " + model_name_);
+        }
+        p_calendar_->restore_checkpoint(initial_state_, 0);
+        p_model_->restore_checkpoint(initial_state_, 0);
+        steps_ = 0;
+        budget_exceeded_ = false;
+        digest_ = Devs::Divergence::Digest{};
+        checkpoints_.clear();
+        replay_base_.reset();
+        parameter_schedule_pending_ = parameter_schedule_.has_value();
+    }
+
+    const Time& checkpoint_time(const size_t idx) const { return checkpoints_.at(idx).time; }
+
+    std::vector<Devs::Metrics::Sample> metrics(const bool finished = false) const {
+        auto samples = Devs::Metrics::progress_samples(model_name_, progress(finished));
+        samples.push_back({"devs_wall_budget_exceeded", "Whether the run was stopped by the wall budget.",
+                           {{"model", model_name_}}, budget_exceeded_ ? 1.0 : 0.0});
+        append_memory_samples(samples);
+        append_event_set_samples(samples);
+        if (!checkpoints_.empty()) {
+            samples.push_back({"devs_checkpoints", "Stored checkpoints.", {{"model", model_name_}},
+                               static_cast<double>(checkpoints_.size())});
+            samples.push_back({"devs_checkpoint_states", "Model states stored by the last checkpoint.",
+                               {{"model", model_name_}}, static_cast<double>(checkpoints_.back().states.size())});
+        }
+        return samples;
+    }
+
+    void sim_started() const {
+
+        p_model_->sim_started([&](const std::string& name, const Time& time, const std::string& state) {
+            p_printer_->on_sim_start(name, time, state);
+        });
+    }
+
+    void sim_ended() {
+
+        p_model_->catch_up();
+        p_model_->flush_output_batches();
+        p_model_->sim_ended([&](const std::string& name, const Time& time, const std::string& state) {
+            p_printer_->on_sim_end(name, time, state);
+        });
+        p_model_->memory_usage([&](const std::string& name, const size_t& current, const size_t& peak) {
+            p_printer_->on_model_memory(name, current, peak);
+        });
+        const auto [current, peak] = calendar_memory();
+        p_printer_->on_calendar_memory(current, peak);
+    }
+
+    void run() {
+        keep_initial_state();
+        schedule_parameter_changes();
+        if (p_partitioned_ != nullptr) {
+            run_partitions();
+            return;
+        }
+        end_replay();
+        // continue the step numbering after restoring a checkpoint
+        Step step{steps_ + 1};
+        wall_start_ = last_progress_ = Clock::now();
+        sim_started();
+        if (checkpoint_interval_ && checkpoints_.empty()) {
+            checkpoint();
+            next_checkpoint_time_ = p_calendar_->time() + *checkpoint_interval_;
+        }
+        while (p_calendar_->execute_next(p_model_->select())) {
+            p_printer_->on_sim_step(p_calendar_->time(), step);
+            steps_ = step;
+            ++step;
+            if (p_hash_file_ && steps_ % hash_interval_ == 0) {
+                write_hash_record();
+            }
+            if (checkpoint_interval_ && p_calendar_->time() >= next_checkpoint_time_) {
+                checkpoint();
+                while (next_checkpoint_time_ <= p_calendar_->time()) {
+                    next_checkpoint_time_ += *checkpoint_interval_;
+                }
+            }
+            if (p_introspection_stream_ != nullptr && Devs::Introspection::consume_request()) {
+                introspect(*p_introspection_stream_);
+            }
+            // reading the clock on every step is measurable on cheap models
+            if ((steps_ & WALL_CHECK_MASK) == 0 && wall_check()) {
+                break;
+            }
+        }
+        publish_progress(true);
+        if (p_hash_file_ && steps_ % hash_interval_ != 0) {
+            write_hash_record();
+        }
+        sim_ended();
+    }
+
+  private: // static members
+    using Clock = std::chrono::steady_clock;
+    static constexpr Step WALL_CHECK_MASK = 0xFF;
+    static constexpr std::chrono::milliseconds PARTITION_POLL{100};
+
+  private: // methods
+    std::vector<Devs::_impl::Calendar<Time>*> calendars() const {
+        std::vector<Devs::_impl::Calendar<Time>*> result{p_calendar_.get()};
+        for (const auto& p_calendar : partition_calendars_) {
+            result.push_back(p_calendar.get());
+        }
+        return result;
+    }
+
+    std::pair<size_t, size_t> calendar_memory() const {
+        size_t current{};
+        size_t peak{};
+        for (const auto p_calendar : calendars()) {
+            current += p_calendar->memory_usage();
+            peak += p_calendar->peak_memory_usage();
+        }
+        return {current, peak};
+    }
+
+    // full snapshot for reset(), a first checkpoint would also be full, so the incremental chain is not affected
+    void keep_initial_state() {
+        if (!reset_enabled_ || steps_ != 0 || !initial_state_.empty() || !checkpoints_.empty()) {
+            return;
+        }
+        initial_state_.push_back({true, {}, 0, 0, 0, {}, {}, {}, {}});
+        p_calendar_->write_checkpoint(initial_state_.back());
+        p_model_->write_checkpoint(initial_state_.back());
+    }
+
+    void schedule_parameter_changes() {
+        if (!parameter_schedule_pending_) {
+            return;
+        }
+        parameter_schedule_pending_ = false;
+        for (const auto& change : parameter_schedule_->changes()) {
+            if (change.time < p_calendar_->time()) {
+                throw std::runtime_error("Parameter update of " + change.component +
+                                         " scheduled before the current time: " + model_name_);
+            }
+            component(change.component).parameter_update(change.time, change.update, change.description);
+        }
+    }
+
+    // the model of the name anywhere within the simulated model, which has to be unique
+    Devs::_impl::IOModel<Time>& component(const std::string& name) {
+        std::vector<Devs::_impl::IOModel<Time>*> found{};
+        std::vector<Devs::_impl::IOModel<Time>*> pending{p_model_.get()};
+        while (!pending.empty()) {
+            const auto p_model = pending.back();
+            pending.pop_back();
+            if (p_model->name() == name) {
+                found.push_back(p_model);
+            }
+            if (const auto p_components = p_model->components()) {
+                for (const auto& [_, p_component] : *p_components) {
+                    pending.push_back(p_component.get());
+                }
+            }
+        }
+        if (found.size() != 1) {
+            throw std::runtime_error("Expected a single model named " + name + " in " + model_name_ + ", found " +
+                                     std::to_string(found.size()));
+        }
+        return *found.front();
+    }
+
+    void restore_state(const size_t idx) {
+        if (idx >= checkpoints_.size()) {
+            throw std::runtime_error("Restoring a non-existing checkpoint: " + std::to_string(idx));
+        }
+        p_calendar_->restore_checkpoint(checkpoints_, idx);
+        p_model_->restore_checkpoint(checkpoints_, idx);
+        steps_ = checkpoints_[idx].step;
+    }
+
+    // the simulation continues from a restored state, the later checkpoints belong to the abandoned future
+    void end_replay() {
+        if (!replay_base_) {
+            return;
+        }
+        checkpoints_.resize(*replay_base_ + 1);
+        replay_base_.reset();
+        if (checkpoint_interval_) {
+            next_checkpoint_time_ = p_calendar_->time() + *checkpoint_interval_;
+        }
+    }
+
+    void require_single_calendar(const std::string& feature) const {
+        if (p_partitioned_ != nullptr) {
+            throw std::runtime_error(feature + " is not supported for models running in partitions: " + model_name_);
+        }
+    }
+
+    // the partitions run concurrently up to the next event of the compound calendar (inputs from sources), which is
+    // then delivered with every partition at its time, partition events at the same time follow the delivery
+    void run_partitions() {
+        if (!p_pool_) {
+            const auto threads = std::min<size_t>(partition_calendars_.size(),
+                                                  std::max(1u, std::thread::hardware_concurrency()));
+            p_pool_ = std::make_unique<Devs::Parallel::ThreadPool>(threads, false);
+        }
+        const auto select = p_model_->select();
+        const auto end_time = p_calendar_->end_time();
+        std::atomic<Step> steps{steps_};
+        std::atomic<bool> stop{false};
+        wall_start_ = last_progress_ = Clock::now();
+        sim_started();
+        while (true) {
+            const auto next = p_calendar_->next_event_time();
+            const auto limit = next && *next <= end_time ? next : std::nullopt;
+            std::vector<std::future<void>> runs{};
+            for (const auto& p_calendar : partition_calendars_) {
+                runs.push_back(p_pool_->submit([this, p_calendar = p_calendar.get(), &select, limit, &steps, &stop]() {
+                    run_partition(*p_calendar, select, limit, steps, stop);
+                }));
+            }
+            for (auto& run : runs) {
+                while (run.wait_for(PARTITION_POLL) != std::future_status::ready) {
+                    if (wall_budget_ && Clock::now() - wall_start_ >= *wall_budget_) {
+                        budget_exceeded_ = true;
+                        stop = true;
+                    }
+                }
+                run.get();
+            }
+            steps_ = steps;
+            p_partitioned_->flush_partition_outputs();
+            if (stop || !limit) {
+                break;
+            }
+            for (const auto& p_calendar : partition_calendars_) {
+                p_calendar->advance_to(*limit);
+            }
+            p_calendar_->execute_next(select);
+            p_partitioned_->flush_partition_outputs();
+            if (p_introspection_stream_ != nullptr && Devs::Introspection::consume_request()) {
+                introspect(*p_introspection_stream_);
+            }
+            if (wall_check()) {
+                break;
+            }
+        }
+        // the compound calendar follows the slowest partition
+        auto time = end_time;
+        for (const auto& p_calendar : partition_calendars_) {
+            time = std::min(time, p_calendar->time());
+        }
+        p_calendar_->advance_to(time);
+        publish_progress(true);
+        sim_ended();
+    }
+
+    void run_partition(Devs::_impl::Calendar<Time>& calendar,
+                       const std::function<std::string(const std::vector<std::string>&)>& select,
+                       const std::optional<Time> limit, std::atomic<Step>& steps, const std::atomic<bool>& stop) {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (limit) {
+                const auto next = calendar.next_event_time();
+                if (!next || !(*next < *limit)) {
+                    return;
+                }
+            }
+            if (!calendar.execute_next(select)) {
+                return;
+            }
+            p_printer_->on_sim_step(calendar.time(), ++steps);
+        }
+    }
+
+    // returns whether the run should stop
+    bool wall_check() {
+        const auto now = Clock::now();
+        if (progress_interval_ && now - last_progress_ >= *progress_interval_) {
+            last_progress_ = now;
+            publish_progress(false);
+        }
+        if (wall_budget_ && now - wall_start_ >= *wall_budget_) {
+            budget_exceeded_ = true;
+            return true;
+        }
+        return false;
+    }
+
+    void append_memory_samples(std::vector<Devs::Metrics::Sample>& samples) const {
+        std::vector<Devs::Metrics::Sample> peaks{};
+        p_model_->memory_usage([&](const std::string& name, const size_t& current, const size_t& peak) {
+            const Devs::Metrics::Labels labels{{"model", model_name_}, {"component", name}};
+            samples.push_back({"devs_model_state_bytes", "Current state bytes of an atomic model.", labels,
+                               static_cast<double>(current)});
+            peaks.push_back({"devs_model_state_peak_bytes", "Peak state bytes of an atomic model.", labels,
+                             static_cast<double>(peak)});
+        });
+        // keep samples of the same name adjacent
+        samples.insert(samples.end(), peaks.begin(), peaks.end());
+        const Devs::Metrics::Labels labels{{"model", model_name_}};
+        const auto [current, peak] = calendar_memory();
+        samples.push_back({"devs_calendar_bytes", "Estimated bytes held by pending events.", labels,
+                           static_cast<double>(current)});
+        samples.push_back({"devs_calendar_peak_bytes", "Estimated peak bytes held by pending events.", labels,
+                           static_cast<double>(peak)});
+    }
+
+    void append_event_set_samples(std::vector<Devs::Metrics::Sample>& samples) const {
+        for (const auto kind : {EventSetKind::BINARY_HEAP, EventSetKind::CALENDAR_QUEUE}) {
+            samples.push_back({"devs_calendar_event_set", "Pending event structure currently in use.",
+                               {{"model", model_name_}, {"structure", event_set_kind_to_str(kind)}},
+                               p_calendar_->event_set_kind() == kind ? 1.0 : 0.0});
+        }
+        const Devs::Metrics::Labels labels{{"model", model_name_}};
+        samples.push_back({"devs_calendar_event_set_migrations_total",
+                           "Migrations between the pending event structures.", labels,
+                           static_cast<double>(p_calendar_->event_set_migrations()),
+                           Devs::Metrics::SampleType::COUNTER});
+        samples.push_back({"devs_calendar_hold_time", "Moving average of the event hold time.", labels,
+                           p_calendar_->hold_time_mean()});
+        std::uint64_t kept{};
+        std::uint64_t rescheduled{};
+        std::uint64_t skipped{};
+        for (const auto p_calendar : calendars()) {
+            kept += p_calendar->kept_transitions();
+            rescheduled += p_calendar->rescheduled_transitions();
+            skipped += p_calendar->skipped_transitions();
+        }
+        samples.push_back({"devs_calendar_kept_transition_ratio",
+                           "Share of the external transitions which kept the pending internal transition in its slot.",
+                           labels, kept + rescheduled > 0 ? static_cast<double>(kept) / (kept + rescheduled) : 0.0});
+        samples.push_back({"devs_reschedules_avoided_total",
+                           "External transitions which kept the pending internal transition (unchanged next time).",
+                           labels, static_cast<double>(kept), Devs::Metrics::SampleType::COUNTER});
+        samples.push_back({"devs_transitions_skipped_total",
+                           "Internal transitions of unobserved periodic models applied without events.", labels,
+                           static_cast<double>(skipped), Devs::Metrics::SampleType::COUNTER});
+    }
+
+    void write_hash_record() {
+        Devs::Divergence::write_record(
+            *p_hash_file_, {steps_, static_cast<double>(p_calendar_->time()), digest_.transitions(), digest_.value()});
+    }
+
+    void publish_progress(const bool finished) {
+        if (progress_interval_) {
+            p_printer_->on_sim_progress(progress(finished));
+        }
+        if (metrics_textfile_) {
+            Devs::Metrics::write_textfile(*metrics_textfile_, metrics(finished));
+        }
+    }
+
+    // the calendars skip materializing events (and transitions of periodic models) for printers ignoring them
+    void trace_events() {
+        for (const auto p_calendar : calendars()) {
+            p_calendar->set_event_tracing(p_printer_->traces_events());
+            p_calendar->set_transition_tracing(p_printer_->traces_transitions());
+        }
+    }
+
+    void setup_calendar_listeners(Devs::_impl::Calendar<Time>& calendar) {
+        calendar.add_time_advanced_listener(
+            [this](const Time& prev, const Time& next) { p_printer_->on_time_advanced(prev, next); });
+        calendar.add_event_scheduled_listener([this](const Time& time, const Devs::_impl::Event<Time>& event) {
+            p_printer_->on_event_scheduled(time, event);
+        });
+        calendar.add_executing_event_action_listener(
+            [this](const Time& time, const Devs::_impl::Event<Time>& event) {
+                p_printer_->on_executing_event_action(time, event);
+            });
+    }
+
+    void setup_model_listeners() {
+        p_model_->add_state_transition_listener(
+            [this](const std::string& name, const Time& time, const std::string& prev, const std::string& next) {
+                p_printer_->on_model_state_transition(name, time, prev, next);
+            });
+    }
+
+  private: // members
+    std::unique_ptr<Devs::_impl::Calendar<Time>> p_calendar_;
+    std::unique_ptr<Devs::Printer::Base<Time, Step>> p_printer_;
+    std::unique_ptr<Devs::_impl::IOModel<Time>> p_model_;
+    std::string model_name_;
+    Time start_time_;
+    Step steps_;
+    std::optional<std::chrono::duration<double>> progress_interval_;
+    std::optional<std::chrono::duration<double>> wall_budget_;
+    std::optional<std::string> metrics_textfile_;
+    bool budget_exceeded_;
+    Clock::time_point wall_start_;
+    Clock::time_point last_progress_;
+    std::ostream* p_introspection_stream_;
+    std::unique_ptr<std::ofstream> p_hash_file_;
+    Step hash_interval_;
+    Devs::Divergence::Digest digest_;
+    std::vector<Devs::_impl::Checkpoint<Time>> checkpoints_;
+    std::optional<Time> checkpoint_interval_;
+    Time next_checkpoint_time_;
+    // checkpoint restored by the last replay, the later ones are kept until the simulation continues
+    std::optional<size_t> replay_base_;
+    bool reset_enabled_;
+    // a single full checkpoint taken by the first run, see enable_reset
+    std::vector<Devs::_impl::Checkpoint<Time>> initial_state_;
+    std::optional<Devs::Model::ParameterSchedule<Time>> parameter_schedule_;
+    bool parameter_schedule_pending_;
+    std::vector<std::unique_ptr<Devs::_impl::Calendar<Time>>> partition_calendars_;
+    Devs::_impl::CompoundImpl<Time>* p_partitioned_;
+    std::unique_ptr<Devs::Parallel::ThreadPool> p_pool_;
+};
+//----------------------------------------------------------------------------------------------------------------------
+namespace Parallel {
+// result of work launched by a transition, consumed by a later transition once its simulated delay has elapsed
+// the delay is advanced by the elapsed times like the rest of the state, the model derives its time advance from it
+// the work runs on the pool while the simulation processes other events, the consuming transition only waits when it
+// is still running, hence the work may only use the values it captured (copies, not references into the state)
+template <typename R, typename Time = double> class Deferred {
+  public: // ctors, dtor
+    Deferred() : result_{}, remaining_{} {}
+
+  private: // ctors, dtor
+    explicit Deferred(std::shared_future<R> result, const Time delay) : result_{std::move(result)}, remaining_{delay} {}
+
+  public: // static functions
+    template <typename F> static Deferred launch(ThreadPool& pool, const Time delay, F work) {
+        return Deferred{pool.submit(std::move(work)).share(), delay};
+    }
+
+    // the work runs on the calling thread, e.g. without a pool
+    template <typename F> static Deferred compute(const Time delay, F work) {
+        std::promise<R> promise{};
+        promise.set_value(work());
+        return Deferred{promise.get_future().share(), delay};
+    }
+
+  public: // methods
+    bool pending() const { return result_.valid(); }
+
+    const Time& remaining() const { return remaining_; }
+
+    void advance(const Time& elapsed) { remaining_ -= elapsed; }
+
+    // whether get would return without waiting
+    bool done() const {
+        return result_.valid() && result_.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    }
+
+    // waits for the work if it is still running, rethrows its exception
+    const R& get() const {
+        if (!result_.valid()) {
+            throw std::runtime_error("No deferred work pending");
+        }
+        return result_.get();
+    }
+
+    void reset() {
+        result_ = {};
+        remaining_ = {};
+    }
+
+  private: // members
+    std::shared_future<R> result_;
+    Time remaining_;
+};
+
+struct SocketThroughput {
+  public: // methods
+    double per_second(const double wall_seconds) const {
+        return wall_seconds > 0.0 ? static_cast<double>(runs) / wall_seconds : 0.0;
+    }
+
+  public: // members
+    int socket;
+    size_t workers;
+    size_t runs;
+    double busy_seconds;
+};
+
+template <typename R> struct Report {
+  public: // methods
+    std::string to_string() const {
+        std::stringstream s;
+        s << std::fixed << std::setprecision(2);
+        s << "Runs: " << results.size() << " in " << wall_seconds << " s ("
+          << (wall_seconds > 0.0 ? static_cast<double>(results.size()) / wall_seconds : 0.0) << " runs/s)\n";
+        for (const auto& socket : sockets) {
+            s << "Socket " << socket.socket << ": workers = " << socket.workers << ", runs = " << socket.runs
+              << ", busy = " << socket.busy_seconds << " s, throughput = " << socket.per_second(wall_seconds)
+              << " runs/s\n";
+        }
+        return s.str();
+    }
+
+  public: // members
+    std::vector<R> results;
+    std::vector<SocketThroughput> sockets;
+    double wall_seconds;
+};
+
+// runs f(point) for every point, each run is executed entirely on a single pinned worker
+// build the simulator inside f so that the model state and calendar are first-touched on the worker's local node
+// the worker is seeded with the index of the point before every run (see Random::seed_stream), offset by the first
+// stream so that the runs of consecutive sweeps do not share their streams
+template <typename P, typename F>
+Report<std::invoke_result_t<F, const P&>> sweep(ThreadPool& pool, const std::vector<P>& points, F f,
+                                                const std::uint64_t first_stream = 0) {
+    using R = std::invoke_result_t<F, const P&>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Run {
+        R result;
+        size_t worker;
+        double seconds;
+    };
+
+    const auto start = Clock::now();
+    std::vector<std::future<Run>> futures{};
+    for (size_t idx = 0; idx < points.size(); ++idx) {
+        futures.push_back(pool.submit([&f, &point = points[idx], stream = first_stream + idx]() {
+            Random::seed_stream(stream);
+            const auto run_start = Clock::now();
+            R result = f(point);
+            const std::chrono::duration<double> seconds = Clock::now() - run_start;
+            return Run{std::move(result), ThreadPool::current_worker().value_or(0), seconds.count()};
+        }));
+    }
+
+    std::map<int, SocketThroughput> sockets{};
+    for (const auto& worker : pool.workers()) {
+        auto& socket = sockets.try_emplace(worker.socket, SocketThroughput{worker.socket, 0, 0, 0.0}).first->second;
+        socket.workers++;
+    }
+
+    // wait for every run first, the tasks reference f and points
+    for (const auto& future : futures) {
+        future.wait();
+    }
+
+    Report<R> report{{}, {}, 0.0};
+    for (auto& future : futures) {
+        auto run = future.get();
+        auto& socket = sockets.at(pool.workers()[run.worker].socket);
+        socket.runs++;
+        socket.busy_seconds += run.seconds;
+        report.results.push_back(std::move(run.result));
+    }
+    const std::chrono::duration<double> wall = Clock::now() - start;
+    report.wall_seconds = wall.count();
+    for (const auto& [_, socket] : sockets) {
+        report.sockets.push_back(socket);
+    }
+    return report;
+}
+
+// independent replications of the same experiment, f receives the replication index (usable as a seed)
+template <typename F> Report<std::invoke_result_t<F, size_t>> replicate(ThreadPool& pool, const size_t count, F f) {
+    std::vector<size_t> replications(count);
+    for (size_t idx = 0; idx < count; ++idx) {
+        replications[idx] = idx;
+    }
+    return sweep(pool, replications, [&f](const size_t& replication) { return f(replication); });
+}
+
+} // namespace Parallel
+//----------------------------------------------------------------------------------------------------------------------
+// metamodels fitted to sweep results, answering what-if queries without running the simulation
+namespace Surrogate {
+
+using Point = std::vector<double>;
+using Kpis = std::vector<double>;
+
+struct Prediction {
+  public: // members
+    Kpis mean;
+    Kpis stddev;
+    // predictive standard deviation relative to the spread of the training results, shared by all KPIs
+    double uncertainty;
+    // answered by a simulation run instead of the metamodel
+    bool simulated = false;
+};
+
+namespace _impl {
+// lower triangular L of a symmetric positive definite row-major matrix, L * L^T = matrix
+inline std::optional<std::vector<double>> cholesky(std::vector<double> matrix, const size_t size) {
+    for (size_t col = 0; col < size; ++col) {
+        auto diagonal = matrix[col * size + col];
+        for (size_t k = 0; k < col; ++k) {
+            diagonal -= matrix[col * size + k] * matrix[col * size + k];
+        }
+        if (diagonal <= 0.0) {
+            return std::nullopt;
+        }
+        matrix[col * size + col] = std::sqrt(diagonal);
+        for (size_t row = col + 1; row < size; ++row) {
+            auto value = matrix[row * size + col];
+            for (size_t k = 0; k < col; ++k) {
+                value -= matrix[row * size + k] * matrix[col * size + k];
+            }
+            matrix[row * size + col] = value / matrix[col * size + col];
+        }
+        for (size_t row = 0; row < col; ++row) {
+            matrix[row * size + col] = 0.0;
+        }
+    }
+    return matrix;
+}
+
+// solves L * x = b in place
+inline void solve_lower(const std::vector<double>& factor, const size_t size, std::vector<double>& x) {
+    for (size_t row = 0; row < size; ++row) {
+        for (size_t k = 0; k < row; ++k) {
+            x[row] -= factor[row * size + k] * x[k];
+        }
+        x[row] /= factor[row * size + row];
+    }
+}
+
+// solves L^T * x = b in place
+inline void solve_upper(const std::vector<double>& factor, const size_t size, std::vector<double>& x) {
+    for (size_t row = size; row-- > 0;) {
+        for (size_t k = row + 1; k < size; ++k) {
+            x[row] -= factor[k * size + row] * x[k];
+        }
+        x[row] /= factor[row * size + row];
+    }
+}
+} // namespace _impl
+
+// Gaussian process regression with a squared exponential kernel over the points scaled to the unit cube
+// the KPIs share the kernel and are standardized separately, the length scale and the noise (replication variance)
+// maximize the marginal likelihood over a fixed grid, refitting is cheap for the few hundred points of a sweep
+class GaussianProcess {
+  public: // methods
+    void fit(std::vector<Point> points, std::vector<Kpis> results) {
+        if (points.empty() || points.size() != results.size()) {
+            throw std::runtime_error("A Gaussian process needs the same (non-zero) number of points and results");
+        }
+        const auto dimensions = points.front().size();
+        const auto kpis = results.front().size();
+        for (size_t idx = 0; idx < points.size(); ++idx) {
+            if (points[idx].size() != dimensions || results[idx].size() != kpis) {
+                throw std::runtime_error("The points or results of a Gaussian process differ in size");
+            }
+        }
+        points_ = std::move(points);
+        results_ = std::move(results);
+        const auto size = points_.size();
+
+        lower_.assign(dimensions, std::numeric_limits<double>::infinity());
+        width_.assign(dimensions, -std::numeric_limits<double>::infinity());
+        for (const auto& point : points_) {
+            for (size_t dim = 0; dim < dimensions; ++dim) {
+                lower_[dim] = std::min(lower_[dim], point[dim]);
+                width_[dim] = std::max(width_[dim], point[dim]);
+            }
+        }
+        for (size_t dim = 0; dim < dimensions; ++dim) {
+            width_[dim] = width_[dim] > lower_[dim] ? width_[dim] - lower_[dim] : 1.0;
+        }
+        mean_.assign(kpis, 0.0);
+        spread_.assign(kpis, 0.0);
+        for (size_t kpi = 0; kpi < kpis; ++kpi) {
+            for (const auto& result : results_) {
+                mean_[kpi] += result[kpi] / static_cast<double>(size);
+            }
+            for (const auto& result : results_) {
+                spread_[kpi] += (result[kpi] - mean_[kpi]) * (result[kpi] - mean_[kpi]) / static_cast<double>(size);
+            }
+            spread_[kpi] = spread_[kpi] > 0.0 ? std::sqrt(spread_[kpi]) : 1.0;
+        }
+        scaled_.clear();
+        for (const auto& point : points_) {
+            scaled_.push_back(scale(point));
+        }
+
+        auto best_likelihood = -std::numeric_limits<double>::infinity();
+        for (const auto length_scale : LENGTH_SCALES) {
+            for (const auto noise : NOISES) {
+                std::vector<double> covariance(size * size);
+                for (size_t row = 0; row < size; ++row) {
+                    for (size_t col = 0; col < size; ++col) {
+                        covariance[row * size + col] =
+                            kernel(scaled_[row], scaled_[col], length_scale) + (row == col ? noise : 0.0);
+                    }
+                }
+                auto factor = _impl::cholesky(std::move(covariance), size);
+                if (!factor) {
+                    continue;
+                }
+                double log_determinant{};
+                for (size_t idx = 0; idx < size; ++idx) {
+                    log_determinant += 2.0 * std::log((*factor)[idx * size + idx]);
+                }
+                std::vector<std::vector<double>> weights{};
+                double likelihood{};
+                for (size_t kpi = 0; kpi < kpis; ++kpi) {
+                    std::vector<double> weight(size);
+                    for (size_t idx = 0; idx < size; ++idx) {
+                        weight[idx] = (results_[idx][kpi] - mean_[kpi]) / spread_[kpi];
+                    }
+                    _impl::solve_lower(*factor, size, weight);
+                    for (const auto value : weight) {
+                        likelihood -= 0.5 * value * value;
+                    }
+                    _impl::solve_upper(*factor, size, weight);
+                    weights.push_back(std::move(weight));
+                }
+                likelihood -= 0.5 * static_cast<double>(kpis) * log_determinant;
+                if (likelihood > best_likelihood) {
+                    best_likelihood = likelihood;
+                    length_scale_ = length_scale;
+                    noise_ = noise;
+                    factor_ = std::move(*factor);
+                    weights_ = std::move(weights);
+                }
+            }
+        }
+        if (factor_.size() != size * size) {
+            throw std::runtime_error("The Gaussian process could not be fitted to the results");
+        }
+    }
+
+    // O(n^2) in the number of fitted points, microseconds for a sweep
+    Prediction predict(const Point& point) const {
+        if (empty()) {
+            throw std::runtime_error("The Gaussian process was not fitted");
+        }
+        if (point.size() != lower_.size()) {
+            throw std::runtime_error("The point does not match the dimensions of the Gaussian process");
+        }
+        const auto size = points_.size();
+        const auto scaled = scale(point);
+        std::vector<double> covariance(size);
+        for (size_t idx = 0; idx < size; ++idx) {
+            covariance[idx] = kernel(scaled, scaled_[idx], length_scale_);
+        }
+        Prediction prediction{Kpis(mean_.size()), Kpis(mean_.size()), 0.0};
+        for (size_t kpi = 0; kpi < mean_.size(); ++kpi) {
+            double value{};
+            for (size_t idx = 0; idx < size; ++idx) {
+                value += covariance[idx] * weights_[kpi][idx];
+            }
+            prediction.mean[kpi] = mean_[kpi] + spread_[kpi] * value;
+        }
+        _impl::solve_lower(factor_, size, covariance);
+        auto variance = 1.0;
+        for (const auto value : covariance) {
+            variance -= value * value;
+        }
+        prediction.uncertainty = std::sqrt(std::max(variance, 0.0));
+        for (size_t kpi = 0; kpi < mean_.size(); ++kpi) {
+            prediction.stddev[kpi] = prediction.uncertainty * spread_[kpi];
+        }
+        return prediction;
+    }
+
+    bool empty() const { return points_.empty(); }
+
+    const std::vector<Point>& points() const { return points_; }
+
+    const std::vector<Kpis>& results() const { return results_; }
+
+    // relative to the widths of the fitted points
+    double length_scale() const { return length_scale_; }
+
+    // relative to the variances of the fitted results
+    double noise() const { return noise_; }
+
+  private: // static members
+    static constexpr std::array<double, 8> LENGTH_SCALES{0.1, 0.2, 0.3, 0.5, 0.7, 1.0, 1.5, 2.0};
+    static constexpr std::array<double, 6> NOISES{1e-6, 1e-4, 1e-3, 1e-2, 0.05, 0.2};
+
+  private: // methods
+    Point scale(const Point& point) const {
+        Point scaled(point.size());
+        for (size_t dim = 0; dim < point.size(); ++dim) {
+            scaled[dim] = (point[dim] - lower_[dim]) / width_[dim];
+        }
+        return scaled;
+    }
+
+    static double kernel(const Point& a, const Point& b, const double length_scale) {
+        double distance{};
+        for (size_t dim = 0; dim < a.size(); ++dim) {
+            distance += (a[dim] - b[dim]) * (a[dim] - b[dim]);
+        }
+        return std::exp(-0.5 * distance / (length_scale * length_scale));
+    }
+
+  private: // members
+    std::vector<Point> points_;
+    std::vector<Point> scaled_;
+    std::vector<Kpis> results_;
+    Point lower_;
+    Point width_;
+    Kpis mean_;
+    Kpis spread_;
+    double length_scale_ = 1.0;
+    double noise_ = 0.0;
+    std::vector<double> factor_;
+    std::vector<std::vector<double>> weights_;
+};
+
+// answers what-if queries from a Gaussian process over sweep results, a query the process is too uncertain about
+// is simulated instead and the result refines the process
+// the uncertainty at the sweep points stays near the square root of the fitted noise, keep the limit above it
+class Metamodel {
+  public: // ctors, dtor
+    explicit Metamodel(std::function<Kpis(const Point&)> simulate, const double max_uncertainty = 0.25)
+        : simulate_{std::move(simulate)}, max_uncertainty_{max_uncertainty}, process_{}, simulations_{0} {}
+
+  public: // methods
+    // simulates the points on the pool (see Devs::Parallel::sweep) and refits the process
+    Parallel::Report<Kpis> train(Parallel::ThreadPool& pool, const std::vector<Point>& points) {
+        auto report = Parallel::sweep(pool, points, simulate_, next_stream());
+        refit(points, report.results);
+        return report;
+    }
+
+    // metamodel only, without a fallback
+    Prediction predict(const Point& point) const { return process_.predict(point); }
+
+    bool certain(const Prediction& prediction) const { return prediction.uncertainty <= max_uncertainty_; }
+
+    // the uncertain queries are simulated together on the pool, their results are the answers
+    std::vector<Prediction> answer(Parallel::ThreadPool& pool, const std::vector<Point>& queries) {
+        std::vector<Prediction> answers{};
+        std::vector<Point> uncertain{};
+        std::vector<size_t> uncertain_idx{};
+        for (const auto& query : queries) {
+            answers.push_back(predict(query));
+            if (!certain(answers.back())) {
+                uncertain.push_back(query);
+                uncertain_idx.push_back(answers.size() - 1);
+            }
+        }
+        if (uncertain.empty()) {
+            return answers;
+        }
+        const auto results = Parallel::sweep(pool, uncertain, simulate_, next_stream()).results;
+        for (size_t idx = 0; idx < results.size(); ++idx) {
+            answers[uncertain_idx[idx]] = {results[idx], Kpis(results[idx].size(), 0.0), 0.0, true};
+        }
+        simulations_ += results.size();
+        refit(uncertain, results);
+        return answers;
+    }
+
+    const GaussianProcess& process() const { return process_; }
+
+    // runs of the fallback, the training excluded
+    size_t simulations() const { return simulations_; }
+
+  private: // methods
+    // every simulation fitted so far used its own random stream, the next ones continue after them
+    std::uint64_t next_stream() const { return process_.points().size(); }
+
+    void refit(const std::vector<Point>& points, const std::vector<Kpis>& results) {
+        auto all_points = process_.points();
+        auto all_results = process_.results();
+        all_points.insert(all_points.end(), points.begin(), points.end());
+        all_results.insert(all_results.end(), results.begin(), results.end());
+        process_.fit(std::move(all_points), std::move(all_results));
+    }
+
+  private: // members
+    std::function<Kpis(const Point&)> simulate_;
+    double max_uncertainty_;
+    GaussianProcess process_;
+    size_t simulations_;
+};
+
+} // namespace Surrogate
 //----------------------------------------------------------------------------------------------------------------------
 } // namespace Devs
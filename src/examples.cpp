@@ -6,6 +6,9 @@
 //----------------------------------------------------------------------------------------------------------------------
 #include <devs/examples.hpp>
 #include <devs/lib.hpp>
+#include <array>
+#include <cstdlib>
+#include <deque>
 #include <queue>
 #include <set>
 #include <variant>
@@ -258,7 +261,7 @@ State delta_external(State state, const TimeT& elapsed, const Input& message) {
         std::cerr << "WARNING: Ignoring unhandled message, code: " << static_cast<int>(message) << "\n";
         return state;
     }
-    assert(elapsed <= ta(s));
+    assert(elapsed <= state.remaining);
     return it->second(state, elapsed);
 }
 
@@ -286,11 +289,98 @@ Output out(const State& state) { return state.next_color; }
 
 TimeT ta(const State& state) { return state.remaining; }
 
+// without inputs, the normal mode cycles red, yellow, green, yellow and the blink mode yellow, dark
+std::optional<TimeT> period(const State& state) {
+    if (!state.powered()) {
+        return {};
+    }
+    if (*state.mode == Mode::NORMAL) {
+        return normal_mode_color_duration(Color::RED) + normal_mode_color_duration(Color::GREEN) +
+               2 * normal_mode_color_duration(Color::YELLOW);
+    }
+    return blink_mode_color_duration(Color::YELLOW) + blink_mode_color_duration({});
+}
+
 Atomic<TrafficLight::Input, TrafficLight::Output, TrafficLight::State> create_model() {
 
     return Atomic<TrafficLight::Input, TrafficLight::Output, TrafficLight::State>{
         TrafficLight::initial_normal_mode_state(), TrafficLight::delta_external, TrafficLight::delta_internal,
-        TrafficLight::out, TrafficLight::ta};
+        TrafficLight::out, TrafficLight::ta, TrafficLight::period};
+}
+
+// the mode and colors take finitely many values, only the remaining time is continuous
+bool same_discrete_state(const State& a, const State& b) {
+    return a.mode == b.mode && a.color == b.color && a.next_color == b.next_color;
+}
+
+std::string discrete_state_to_str(const State& state) {
+    const auto mode = state.powered() ? mode_to_str(*state.mode) : "off";
+    const auto color = state.color ? color_to_str(*state.color) : "{}";
+    const auto next_color = state.next_color ? color_to_str(*state.next_color) : "{}";
+    return mode + " " + color + " -> " + next_color;
+}
+
+// tabulates the handlers above over the discrete states reachable from the initial state
+// external transitions keeping the schedule (identity_state) continue the remaining time, the rest restart it
+Devs::Model::FiniteState<Input, Output, TimeT> create_finite_state_model() {
+    using External = Devs::Model::FiniteState<Input, Output, TimeT>::External;
+    constexpr auto input_count = static_cast<size_t>(Input::_ENUM_MEMBER_COUNT);
+
+    std::vector<State> states{initial_normal_mode_state()};
+    const auto index_of = [&states](const State& state) {
+        const auto it = std::find_if(states.begin(), states.end(),
+                                     [&state](const State& other) { return same_discrete_state(state, other); });
+        if (it != states.end()) {
+            return static_cast<size_t>(it - states.begin());
+        }
+        states.push_back(state);
+        return states.size() - 1;
+    };
+
+    std::vector<size_t> internal{};
+    std::vector<External> external{};
+    // discovered states are appended while iterating
+    for (size_t i = 0; i < states.size(); ++i) {
+        const auto state = states[i];
+        internal.push_back(state.powered() ? index_of(delta_internal(state)) : i);
+        // a nonzero elapsed time tells continued schedules from restarted ones
+        const auto elapsed = std::isfinite(state.remaining) ? state.remaining / 2 : 0.0;
+        for (size_t input = 0; input < input_count; ++input) {
+            const auto next = delta_external(state, elapsed, static_cast<Input>(input));
+            const auto continues = std::isfinite(state.remaining) && same_discrete_state(state, next) &&
+                                   next.remaining == state.remaining - elapsed;
+            external.push_back({index_of(next), continues});
+        }
+    }
+
+    return {
+        states.size(),
+        input_count,
+        0,
+        [](const Input& input) { return static_cast<size_t>(input); },
+        [internal](size_t state) { return internal[state]; },
+        [external](size_t state, size_t input) {
+            return external[state * static_cast<size_t>(Input::_ENUM_MEMBER_COUNT) + input];
+        },
+        [states](size_t state) { return out(states[state]); },
+        [states](size_t state) { return ta(states[state]); },
+        [states](size_t state) { return discrete_state_to_str(states[state]); },
+    };
+}
+
+// independent traffic lights receiving the same external inputs, optionally coupled to the output of the compound
+Compound create_grid_model(const size_t lights, const Devs::Model::AbstractModelFactory<TimeT>& light,
+                           const bool outputs) {
+    Compound compound{{}, {}};
+    for (size_t i = 0; i < lights; ++i) {
+        const auto name = "traffic light " + std::to_string(i);
+        compound.components.emplace(name, light);
+        if (outputs) {
+            compound.influencers[{}].emplace(name, Devs::Model::Transformer{});
+        }
+        compound.influencers[name].emplace(std::nullopt, Devs::Model::Transformer{});
+    }
+    return compound;
 }
 
 void setup_inputs_outputs(Simulator& simulator, const TimeT& start_time, const TimeT& end_time) {
@@ -379,6 +469,13 @@ struct SelfCheckoutParameters {
     double age_verify_rate;
 };
 
+// impatient customers leave the checkout queues (reneging) and do not join them when both are too long (balking)
+struct PatienceParameters {
+  public: // members
+    double renege_rate;
+    size_t balk_queue_size;
+};
+
 struct Parameters {
   public: // members
     TimeParameters time;
@@ -387,6 +484,7 @@ struct Parameters {
     SelfServiceParameters self_service;
     CheckoutParameters checkout;
     SelfCheckoutParameters self_checkout;
+    std::optional<PatienceParameters> patience = {};
 };
 
 class Customer {
@@ -402,6 +500,9 @@ class Customer {
     bool product_counter;
     bool self_service = true;
     bool checkout = true;
+    // left without checking out, see PatienceParameters
+    bool reneged = false;
+    bool balked = false;
 };
 
 struct Server {
@@ -415,14 +516,19 @@ struct Server {
     TimeT remaining;
     TimeT total_busy_time;
     TimeT total_error_time;
+    // closed servers take no new customers, see Servers::set_open_servers
+    bool open = true;
 };
 
+// waiting customers with a patience timeout renege when it runs out
 class Servers {
   public: // ctors, dtor
     Servers(const std::string& name, const size_t servers, const std::function<double()> gen_service_time,
-            const std::function<std::optional<TimeT>()> gen_error)
-        : name_{name}, gen_service_time_{gen_service_time}, gen_error_{gen_error},
-          servers_{servers, Server{{}, 0.0, 0.0, 0.0}}, queue_{}, queue_occupancy_sum_{}, served_customers_{0} {
+            const std::function<std::optional<TimeT>()> gen_error,
+            const std::function<std::optional<TimeT>()> gen_patience = {})
+        : name_{name}, gen_service_time_{gen_service_time}, gen_error_{gen_error}, gen_patience_{gen_patience},
+          servers_{servers, Server{{}, 0.0, 0.0, 0.0}}, queue_{}, front_ticket_{0}, waiting_customers_{0},
+          patience_timers_{Time::SECOND}, queue_occupancy_sum_{}, served_customers_{0}, reneged_customers_{0} {
         if (servers == 0) {
             throw std::runtime_error("Number of server set to 0");
         }
@@ -434,17 +540,24 @@ class Servers {
         for (size_t i = 0; i < state.servers().size(); ++i) {
             const auto& server = state.servers()[i];
             if (server.busy()) {
-                os << "busy: " << server.remaining;
+                os << (server.open ? "busy: " : "closing: ") << server.remaining;
             } else {
-                os << "idle";
+                os << (server.open ? "idle" : "closed");
             }
             os << " | ";
         }
         return os << "Q: " << state.queue_size();
     }
 
+  private: // types
+    struct WaitingCustomer {
+        Customer customer;
+        std::optional<Devs::Timer::Wheel<std::uint64_t, TimeT>::Handle> patience;
+        bool reneged;
+    };
+
   public: // methods
-    bool has_waiting_customer() const { return !queue_.empty(); }
+    bool has_waiting_customer() const { return waiting_customers_ > 0; }
 
     size_t busy_server_count() const {
         size_t count = 0;
@@ -459,13 +572,46 @@ class Servers {
 
     size_t idle_server_count() const { return servers_.size() - busy_server_count(); }
 
+    size_t open_server_count() const {
+        return static_cast<size_t>(
+            std::count_if(servers_.begin(), servers_.end(), [](const Server& server) { return server.open; }));
+    }
+
+    // staffing change, the closed busy servers finish serving their customer first
+    // closing prefers the idle servers, opening the closing ones, new servers are added only when none are closed
+    void set_open_servers(const size_t count) {
+        if (count == 0) {
+            throw std::runtime_error("Number of open servers set to 0");
+        }
+        auto open = open_server_count();
+        for (const auto busy : {true, false}) {
+            for (auto& server : servers_) {
+                if (open < count && !server.open && server.busy() == busy) {
+                    server.open = true;
+                    ++open;
+                }
+            }
+        }
+        for (; open < count; ++open) {
+            servers_.push_back(Server{{}, 0.0, 0.0, 0.0});
+        }
+        for (const auto busy : {false, true}) {
+            for (auto server = servers_.rbegin(); server != servers_.rend(); ++server) {
+                if (open > count && server->open && server->busy() == busy) {
+                    server->open = false;
+                    --open;
+                }
+            }
+        }
+    }
+
     bool all_servers_idle() const { return busy_server_count() == 0; }
 
     bool idle() const { return !has_waiting_customer() && all_servers_idle(); }
 
     std::optional<size_t> idle_server_idx() const {
         for (auto server = servers_.begin(); server != servers_.end(); server += 1) {
-            if (server->idle()) {
+            if (server->idle() && server->open) {
                 return std::distance(servers_.begin(), server);
             }
         }
@@ -543,17 +689,53 @@ class Servers {
             assign_customer_to_server(customer, *server_idx, service_time);
             return;
         }
-        queue_.push(customer);
+        WaitingCustomer waiting{customer, std::nullopt, false};
+        if (const auto patience = gen_patience_ ? gen_patience_() : std::nullopt) {
+            // the ticket locates the customer in the queue once the patience runs out
+            waiting.patience = patience_timers_.arm(*patience, front_ticket_ + queue_.size());
+        }
+        queue_.push_back(waiting);
+        ++waiting_customers_;
     }
 
     std::optional<Customer> next_customer() const {
         if (!has_waiting_customer()) {
             return std::nullopt;
         }
-        return queue_.front();
+        return queue_.front().customer;
     }
 
-    void pop_customer() { queue_.pop(); }
+    void pop_customer() {
+        if (const auto& patience = queue_.front().patience) {
+            patience_timers_.cancel(*patience);
+        }
+        queue_.pop_front();
+        ++front_ticket_;
+        --waiting_customers_;
+        drop_reneged_customers();
+    }
+
+    // the patience of a waiting customer runs out before the next server finishes
+    bool renege_due() const {
+        const auto renege = remaining_to_next_renege();
+        const auto ready = remaining_to_next_ready();
+        return renege && (!ready || *renege < *ready);
+    }
+
+    std::optional<TimeT> remaining_to_next_renege() const { return patience_timers_.next_timeout(); }
+
+    const Customer& next_reneging_customer() const {
+        return queue_[patience_timers_.next() - front_ticket_].customer;
+    }
+
+    void renege_customer() {
+        auto& waiting = queue_[patience_timers_.pop() - front_ticket_];
+        waiting.patience = std::nullopt;
+        waiting.reneged = true;
+        --waiting_customers_;
+        ++reneged_customers_;
+        drop_reneged_customers();
+    }
 
     void advance_time(const TimeT delta) {
         for (auto& server : servers_) {
@@ -561,12 +743,13 @@ class Servers {
                 server.remaining -= delta;
             }
         }
-        queue_occupancy_sum_ += delta * static_cast<TimeT>(queue_.size());
+        patience_timers_.advance(delta);
+        queue_occupancy_sum_ += delta * static_cast<TimeT>(waiting_customers_);
     }
 
     const std::vector<Server>& servers() const { return servers_; }
 
-    size_t queue_size() const { return queue_.size(); }
+    size_t queue_size() const { return waiting_customers_; }
 
     std::vector<double> server_busy_ratios(const TimeT duration) const {
         std::vector<double> ratios{};
@@ -637,14 +820,51 @@ class Servers {
 
     int served_customers() const { return served_customers_; }
 
+    int reneged_customers() const { return reneged_customers_; }
+
+    bool impatient_customers() const { return gen_patience_ != nullptr; }
+
+    size_t memory_usage() const {
+        return servers_.capacity() * sizeof(Server) + queue_.size() * sizeof(WaitingCustomer) +
+               patience_timers_.memory_usage();
+    }
+
+    // the printed state omits the statistics, hash them for the Devs::Traits::StateHash trait
+    std::uint64_t hash() const {
+        std::stringstream s;
+        s << std::setprecision(std::numeric_limits<double>::max_digits10) << *this << " | " << queue_occupancy_sum_
+          << " | " << served_customers_;
+        for (const auto& server : servers_) {
+            s << " | " << server.remaining << " " << server.total_busy_time << " " << server.total_error_time;
+        }
+        if (impatient_customers()) {
+            s << " | " << reneged_customers_;
+        }
+        return Devs::Traits::fnv1a(s.str());
+    }
+
+  private: // methods
+    // reneged customers stay in the queue until they reach its front
+    void drop_reneged_customers() {
+        while (!queue_.empty() && queue_.front().reneged) {
+            queue_.pop_front();
+            ++front_ticket_;
+        }
+    }
+
   private: // members
     std::string name_;
     std::function<double()> gen_service_time_;
     std::function<std::optional<TimeT>()> gen_error_;
+    std::function<std::optional<TimeT>()> gen_patience_;
     std::vector<Server> servers_;
-    std::queue<Customer> queue_;
+    std::deque<WaitingCustomer> queue_;
+    std::uint64_t front_ticket_;
+    size_t waiting_customers_;
+    Devs::Timer::Wheel<std::uint64_t, TimeT> patience_timers_;
     TimeT queue_occupancy_sum_;
     int served_customers_;
+    int reneged_customers_;
 };
 
 namespace CustomerCoordinator {
@@ -689,8 +909,9 @@ using Message = std::variant<TargetedCustomer, Queries, CheckoutQueueSizeRespons
 
 class State {
   public: // ctors, dtor
-    State(const std::string name)
-        : name_{name}, customers_{}, awaiting_responses_{false}, checkout_response_{}, self_checkout_response_{} {}
+    State(const std::string name, const std::optional<size_t> balk_queue_size = {})
+        : name_{name}, customers_{}, awaiting_responses_{false}, checkout_response_{}, self_checkout_response_{},
+          balk_queue_size_{balk_queue_size}, balked_customers_{0} {}
 
   public: // friends
     friend std::ostream& operator<<(std::ostream& os, const State& state) {
@@ -767,6 +988,16 @@ class State {
 
     bool responses_received() const { return checkout_response_received() && self_checkout_response_received(); }
 
+    // both checkout queues are too long for the customer to join either
+    bool next_customer_balks() const {
+        return balk_queue_size_ && responses_received() &&
+               std::min(checkout_response()->queue_size, self_checkout_response()->queue_size) >= *balk_queue_size_;
+    }
+
+    void customer_balked() { ++balked_customers_; }
+
+    int balked_customers() const { return balked_customers_; }
+
     void add_customer(const Customer customer) { customers_.push(customer); }
 
     void pop_customer() { customers_.pop(); }
@@ -775,12 +1006,16 @@ class State {
 
     const std::string& name() const { return name_; }
 
+    size_t memory_usage() const { return customers_.size() * sizeof(Customer); }
+
   private: // members
     std::string name_;
     std::queue<Customer> customers_;
     bool awaiting_responses_;
     std::optional<CheckoutQueueSizeResponse> checkout_response_;
     std::optional<CheckoutQueueSizeResponse> self_checkout_response_;
+    std::optional<size_t> balk_queue_size_;
+    int balked_customers_;
 };
 
 void delta_external_add_customer(State& state, const TargetedCustomer& tc) {
@@ -844,6 +1079,9 @@ State delta_internal(State state) {
     }
 
     if (state.responses_received()) {
+        if (state.next_customer_balks()) {
+            state.customer_balked();
+        }
         state.clear_responses();
         state.pop_customer();
         return state;
@@ -862,6 +1100,12 @@ Message out_responses_received(const State& state) {
     if (!state.next_customer_to_checkout()) {
         throw std::runtime_error("Unexpected customer in out_responses_received of CustomerCoordinator");
     }
+    if (state.next_customer_balks()) {
+        auto customer = *state.next_customer_ref();
+        customer.checkout = false;
+        customer.balked = true;
+        return TargetedCustomer{customer, CustomerOutput::MODEL_NAME};
+    }
     // prefer checkout over self-checkout when even
     if (state.checkout_response()->queue_size <= state.self_checkout_response()->queue_size) {
         return TargetedCustomer{*state.next_customer_ref(), Checkout::MODEL_NAME};
@@ -916,8 +1160,10 @@ TimeT ta(const State& state) {
     return Devs::Const::INF;
 }
 
-Atomic<Message, Message, State> create_model() {
-    return Atomic<Message, Message, State>{State{MODEL_NAME}, delta_external, delta_internal, out, ta};
+Atomic<Message, Message, State> create_model(const std::optional<PatienceParameters>& patience) {
+    const auto balk_queue_size = patience ? std::optional<size_t>{patience->balk_queue_size} : std::nullopt;
+    return Atomic<Message, Message, State>{State{MODEL_NAME, balk_queue_size}, delta_external, delta_internal, out,
+                                           ta};
 }
 } // namespace CustomerCoordinator
 
@@ -1091,6 +1337,8 @@ class State {
         return std::addressof(customers_[*idx].customer);
     }
 
+    size_t memory_usage() const { return customers_.capacity() * sizeof(CustomerState); }
+
   private: // members
     std::string name_;
     std::function<double()> gen_service_time_;
@@ -1157,12 +1405,21 @@ std::function<std::optional<TimeT>()> error_generator(const double error_chance,
     };
 }
 
+std::function<std::optional<TimeT>()> patience_generator(const std::optional<PatienceParameters>& patience) {
+    if (!patience) {
+        return {};
+    }
+    return [gen_time = Devs::Random::exponential(patience->renege_rate)]() -> std::optional<TimeT> {
+        return gen_time();
+    };
+}
+
 class State : public Servers {
   public: // ctors, dtor
     State(const std::string name, const size_t servers, const double service_rate, const double error_chance,
-          const double error_handle_rate)
+          const double error_handle_rate, const std::optional<PatienceParameters>& patience = {})
         : Servers{name, servers, Devs::Random::exponential(service_rate),
-                  error_generator(error_chance, error_handle_rate)},
+                  error_generator(error_chance, error_handle_rate), patience_generator(patience)},
           sending_response_{false} {}
 
   public: // friends
@@ -1212,13 +1469,14 @@ void delta_internal_finish_serving(State& state) {
 }
 
 void delta_internal_next_customer(State& state) {
+    // the finished server may have been closed meanwhile (see Servers::set_open_servers)
+    const auto idle_idx = state.idle_server_idx();
+    if (idle_idx == std::nullopt) {
+        return;
+    }
     // no need to check more than once as only one server may finish during an internal delta
     if (const auto customer = state.next_customer()) {
         state.pop_customer();
-        const auto idle_idx = state.idle_server_idx();
-        if (idle_idx == std::nullopt) {
-            throw std::runtime_error("Expected at least one idle server in Checkout during internal transition");
-        }
         state.assign_customer_to_server(*customer, *idle_idx, state.gen_service_time());
     }
 }
@@ -1233,6 +1491,12 @@ State delta_internal(State state) {
         throw std::runtime_error("Internal delta in Checkout while idle");
     }
 
+    if (state.renege_due()) {
+        state.advance_time(*state.remaining_to_next_renege());
+        state.renege_customer();
+        return state;
+    }
+
     delta_internal_finish_serving(state);
     delta_internal_next_customer(state);
 
@@ -1258,6 +1522,14 @@ CustomerCoordinator::Message out(const State& state) {
         throw std::runtime_error("Output in Checkout while idle");
     }
 
+    if (state.renege_due()) {
+        // the customer leaves without checking out
+        auto customer = state.next_reneging_customer();
+        customer.checkout = false;
+        customer.reneged = true;
+        return CustomerCoordinator::TargetedCustomer{customer, CustomerCoordinator::MODEL_NAME};
+    }
+
     return next_finished_customer(state);
 }
 
@@ -1271,6 +1543,10 @@ TimeT ta(const State& state) {
         return Devs::Const::INF;
     }
 
+    if (state.renege_due()) {
+        return *state.remaining_to_next_renege();
+    }
+
     if (const auto remaining = state.remaining_to_next_ready()) {
         return *remaining;
     }
@@ -1279,21 +1555,35 @@ TimeT ta(const State& state) {
 }
 
 Atomic<CustomerCoordinator::Message, CustomerCoordinator::Message, State>
-create_model(const CheckoutParameters& parameters) {
+create_model(const CheckoutParameters& parameters, const std::optional<PatienceParameters>& patience) {
     return Atomic<CustomerCoordinator::Message, CustomerCoordinator::Message, State>{
         State{MODEL_NAME, parameters.servers, parameters.service_rate, parameters.error_chance,
-              parameters.error_handle_rate},
+              parameters.error_handle_rate, patience},
         delta_external, delta_internal, out, ta};
 }
+
+// opens or closes checkouts during a run (see Devs::Model::ParameterSchedule), the opened ones take the waiting
+// customers right away
+Devs::Model::ParameterUpdate<State, TimeT> staffing(const size_t servers) {
+    return [servers](State state, const TimeT& elapsed) {
+        state.advance_time(elapsed);
+        state.set_open_servers(servers);
+        while (state.has_waiting_customer() && state.idle_server_idx()) {
+            delta_internal_next_customer(state);
+        }
+        return state;
+    };
+}
 } // namespace Checkout
 
 namespace SelfCheckout {
 
 class State : public Checkout::State {
   public: // ctors, dtor
-    State(const std::string name, const SelfCheckoutParameters& parameters)
+    State(const std::string name, const SelfCheckoutParameters& parameters,
+          const std::optional<PatienceParameters>& patience)
         : Checkout::State{name, parameters.servers, parameters.service_rate, parameters.error_chance,
-                          parameters.error_handle_rate},
+                          parameters.error_handle_rate, patience},
           gen_age_verify_time_{Devs::Random::exponential(parameters.age_verify_rate)} {}
 
   public: // friends
@@ -1346,13 +1636,14 @@ void delta_internal_finish_serving(State& state) {
 }
 
 void delta_internal_next_customer(State& state) {
+    // the finished server may have been closed meanwhile (see Servers::set_open_servers)
+    const auto idle_idx = state.idle_server_idx();
+    if (idle_idx == std::nullopt) {
+        return;
+    }
     // no need to check more than once as only one server may finish during an internal delta
     if (const auto customer = state.next_customer()) {
         state.pop_customer();
-        const auto idle_idx = state.idle_server_idx();
-        if (idle_idx == std::nullopt) {
-            throw std::runtime_error("Expected at least one idle server in SelfCheckout during internal transition");
-        }
         state.assign_customer_to_server(*customer, *idle_idx,
                                         state.gen_service_time() + state.gen_age_verify_time(customer->age_verify));
     }
@@ -1368,6 +1659,12 @@ State delta_internal(State state) {
         throw std::runtime_error("Internal delta in SelfCheckout while idle");
     }
 
+    if (state.renege_due()) {
+        state.advance_time(*state.remaining_to_next_renege());
+        state.renege_customer();
+        return state;
+    }
+
     delta_internal_finish_serving(state);
     delta_internal_next_customer(state);
 
@@ -1393,6 +1690,14 @@ CustomerCoordinator::Message out(const State& state) {
         throw std::runtime_error("Output in SelfCheckout while idle");
     }
 
+    if (state.renege_due()) {
+        // the customer leaves without checking out
+        auto customer = state.next_reneging_customer();
+        customer.checkout = false;
+        customer.reneged = true;
+        return CustomerCoordinator::TargetedCustomer{customer, CustomerCoordinator::MODEL_NAME};
+    }
+
     return next_finished_customer(state);
 }
 
@@ -1406,6 +1711,10 @@ TimeT ta(const State& state) {
         return Devs::Const::INF;
     }
 
+    if (state.renege_due()) {
+        return *state.remaining_to_next_renege();
+    }
+
     if (const auto remaining = state.remaining_to_next_ready()) {
         return *remaining;
     }
@@ -1414,9 +1723,9 @@ TimeT ta(const State& state) {
 }
 
 Atomic<CustomerCoordinator::Message, CustomerCoordinator::Message, State>
-create_model(const SelfCheckoutParameters& parameters) {
+create_model(const SelfCheckoutParameters& parameters, const std::optional<PatienceParameters>& patience) {
     return Atomic<CustomerCoordinator::Message, CustomerCoordinator::Message, State>{
-        State{MODEL_NAME, parameters}, delta_external, delta_internal, out, ta};
+        State{MODEL_NAME, parameters, patience}, delta_external, delta_internal, out, ta};
 }
 } // namespace SelfCheckout
 
@@ -1449,6 +1758,8 @@ class State {
 
     const std::string& name() const { return name_; }
 
+    size_t memory_usage() const { return customers_.size() * sizeof(Customer); }
+
   private: // membersS
     std::string name_;
     std::queue<Customer> customers_;
@@ -1492,13 +1803,157 @@ Atomic<CustomerCoordinator::Message, Customer, State> create_model() {
 }
 } // namespace CustomerOutput
 
+// expected waiting time at the checkout for the throughput observed over the last window, estimated by simulating an
+// M/M/c queue, the expensive estimate runs on a computation pool and is consumed a fixed simulated delay later
+namespace Forecast {
+constexpr auto MODEL_NAME = "Checkout forecast";
+constexpr TimeT WINDOW = 15 * Time::MINUTE;
+constexpr TimeT DELAY = 5 * Time::MINUTE;
+constexpr size_t SAMPLES = 200000;
+
+// Kiefer-Wolfowitz recursion, every customer takes the server which becomes free first
+double mean_waiting_time(const double arrival_rate, const double service_rate, const size_t servers,
+                         const std::uint64_t seed) {
+    if (arrival_rate <= 0.0) {
+        return 0.0;
+    }
+    Devs::Random::Engine engine{seed};
+    std::exponential_distribution<double> gen_arrival{arrival_rate};
+    std::exponential_distribution<double> gen_service{service_rate};
+    std::vector<double> free_at(servers, 0.0);
+    double time{};
+    double waiting{};
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        time += gen_arrival(engine);
+        const auto server = std::min_element(free_at.begin(), free_at.end());
+        const auto start = std::max(time, *server);
+        waiting += start - time;
+        *server = start + gen_service(engine);
+    }
+    return waiting / static_cast<double>(SAMPLES);
+}
+
+class State {
+  public: // ctors, dtor
+    State(const CheckoutParameters& checkout, Devs::Parallel::ThreadPool* p_pool)
+        : service_rate_{checkout.service_rate}, servers_{checkout.servers}, p_pool_{p_pool},
+          window_remaining_{WINDOW}, window_{0}, served_customers_{0}, pending_{}, forecasts_{0}, forecast_sum_{} {}
+
+  public: // friends
+    friend std::ostream& operator<<(std::ostream& os, const State& state) {
+        return os << "window: " << state.window_ << ", served: " << state.served_customers_
+                  << ", forecasts: " << state.forecasts_;
+    }
+
+  public: // methods
+    void advance_time(const TimeT delta) {
+        window_remaining_ -= delta;
+        if (pending_.pending()) {
+            pending_.advance(delta);
+        }
+    }
+
+    void customer_served() { ++served_customers_; }
+
+    TimeT remaining() const {
+        return pending_.pending() ? std::min(window_remaining_, pending_.remaining()) : window_remaining_;
+    }
+
+    bool forecast_due() const { return pending_.pending() && pending_.remaining() < Time::EPS; }
+
+    // waits only when the estimate is still being computed
+    void consume_forecast() {
+        forecast_sum_ += pending_.get();
+        ++forecasts_;
+        pending_.reset();
+    }
+
+    bool window_ended() const { return window_remaining_ < Time::EPS; }
+
+    void launch_forecast() {
+        if (pending_.pending()) {
+            throw std::runtime_error("Launching a forecast while the previous one is pending");
+        }
+        // the work captures copies, it runs while the simulation continues
+        // saturated windows are capped, the waiting time of a queue at full utilization is unbounded
+        const auto utilization_cap = 0.95 * service_rate_ * static_cast<double>(servers_);
+        const auto work = [arrival_rate = std::min(served_customers_ / WINDOW, utilization_cap),
+                           service_rate = service_rate_, servers = servers_, seed = window_]() {
+            return mean_waiting_time(arrival_rate, service_rate, servers, seed);
+        };
+        pending_ = p_pool_ != nullptr ? Devs::Parallel::Deferred<double, TimeT>::launch(*p_pool_, DELAY, work)
+                                      : Devs::Parallel::Deferred<double, TimeT>::compute(DELAY, work);
+        window_remaining_ = WINDOW;
+        served_customers_ = 0;
+        ++window_;
+    }
+
+    // the estimates run on the pool when set, on the simulation thread otherwise
+    void set_pool(Devs::Parallel::ThreadPool* p_pool) { p_pool_ = p_pool; }
+
+    size_t forecasts() const { return forecasts_; }
+
+    double mean_forecast() const { return forecasts_ > 0 ? forecast_sum_ / static_cast<double>(forecasts_) : 0.0; }
+
+  private: // members
+    double service_rate_;
+    size_t servers_;
+    Devs::Parallel::ThreadPool* p_pool_;
+    TimeT window_remaining_;
+    std::uint64_t window_;
+    size_t served_customers_;
+    Devs::Parallel::Deferred<double, TimeT> pending_;
+    size_t forecasts_;
+    double forecast_sum_;
+};
+
+State delta_external(State state, const TimeT& elapsed, const CustomerCoordinator::Message& message) {
+    state.advance_time(elapsed);
+    const CustomerCoordinator::TargetedCustomer* tc =
+        std::get_if<CustomerCoordinator::TargetedCustomer>(std::addressof(message));
+    if (tc != nullptr && !tc->customer.reneged) {
+        state.customer_served();
+    }
+    // ignore other messages
+    return state;
+}
+
+State delta_internal(State state) {
+    state.advance_time(state.remaining());
+    if (state.forecast_due()) {
+        state.consume_forecast();
+    }
+    if (state.window_ended()) {
+        state.launch_forecast();
+    }
+    return state;
+}
+
+Null out(const State&) { return {}; }
+
+TimeT ta(const State& state) { return std::max(state.remaining(), 0.0); }
+
+Devs::Model::ParameterUpdate<State, TimeT> computation_pool(Devs::Parallel::ThreadPool* p_pool) {
+    return [p_pool](State state, const TimeT& elapsed) {
+        state.advance_time(elapsed);
+        state.set_pool(p_pool);
+        return state;
+    };
+}
+
+Atomic<CustomerCoordinator::Message, Null, State> create_model(const CheckoutParameters& checkout) {
+    return Atomic<CustomerCoordinator::Message, Null, State>{State{checkout, nullptr}, delta_external, delta_internal,
+                                                             out, ta};
+}
+} // namespace Forecast
+
 std::unordered_map<std::string, Devs::Model::AbstractModelFactory<TimeT>> components(const Parameters& parameters) {
-    return {{CustomerCoordinator::MODEL_NAME, CustomerCoordinator::create_model()},
+    return {{CustomerCoordinator::MODEL_NAME, CustomerCoordinator::create_model(parameters.patience)},
             {ProductCounter::MODEL_NAME, ProductCounter::create_model(parameters.product_counter)},
             {CustomerOutput::MODEL_NAME, CustomerOutput::create_model()},
             {SelfService::MODEL_NAME, SelfService::create_model(parameters.self_service)},
-            {Checkout::MODEL_NAME, Checkout::create_model(parameters.checkout)},
-            {SelfCheckout::MODEL_NAME, SelfCheckout::create_model(parameters.self_checkout)}};
+            {Checkout::MODEL_NAME, Checkout::create_model(parameters.checkout, parameters.patience)},
+            {SelfCheckout::MODEL_NAME, SelfCheckout::create_model(parameters.self_checkout, parameters.patience)}};
 }
 
 Devs::Dynamic customer_to_message(const Devs::Dynamic& customer) {
@@ -1548,6 +2003,96 @@ void setup_inputs_outputs(Simulator& simulator, const Parameters parameters, con
     }
 }
 
+// customers per hour over a day (closed at night, morning, lunch and evening peaks), sampled every 15 minutes
+std::vector<Devs::Random::RatePoint> daily_arrival_profile(const double peak_per_hour) {
+    constexpr std::array<double, 25> shape{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.1, 0.6, 0.8, 0.5, 0.6, 0.9,
+                                           0.7, 0.5, 0.5, 0.7, 1.0, 0.9, 0.6, 0.3, 0.0, 0.0, 0.0, 0.0};
+    constexpr size_t quarters = 4;
+    std::vector<Devs::Random::RatePoint> profile{};
+    for (size_t hour = 0; hour + 1 < shape.size(); ++hour) {
+        for (size_t quarter = 0; quarter < quarters; ++quarter) {
+            const auto fraction = static_cast<double>(quarter) / quarters;
+            const auto relative = shape[hour] * (1.0 - fraction) + shape[hour + 1] * fraction;
+            profile.push_back({(static_cast<double>(hour) + fraction) * Time::HOUR,
+                               relative * peak_per_hour / Time::HOUR});
+        }
+    }
+    profile.push_back({24 * Time::HOUR, shape.back() * peak_per_hour / Time::HOUR});
+    return profile;
+}
+
+// arrivals pulled lazily from the daily profile instead of being scheduled upfront
+void setup_daily_inputs(Simulator& simulator, const Parameters& parameters, const double peak_per_hour) {
+    simulator.model().external_input_source(
+        Devs::Model::arrival_source<TimeT>(
+            Devs::Random::piecewise_poisson_arrivals(daily_arrival_profile(peak_per_hour),
+                                                     Devs::Random::Interpolation::LINEAR, parameters.time.start),
+            parameters.time.end,
+            // the source owns its generator, so it is restored with the source by checkpoints
+            [customer = parameters.customer, generator = Devs::Random::uniform()]() mutable -> Devs::Dynamic {
+                return Customer::create_random(customer.age_verify_chance, customer.product_counter_chance,
+                                               [&generator]() { return generator(); });
+            }),
+        "customer arrival");
+}
+
+// strictly positive finite number, e.g. a duration in seconds read from an environment variable
+double parse_positive(const std::string& variable, const std::string& value) {
+    char* p_end{nullptr};
+    const auto number = std::strtod(value.c_str(), &p_end);
+    if (value.empty() || p_end != value.c_str() + value.size() || !std::isfinite(number) || number <= 0.0) {
+        throw std::runtime_error("Expected a positive number in " + variable + ", got: " + value);
+    }
+    return number;
+}
+
+// long runs report their progress every second and dump their state on SIGUSR1, the optional environment variables
+// enable a Prometheus textfile export, a wall-clock budget and state hash recording
+void setup_progress(Simulator& simulator) {
+    simulator.set_progress_interval(std::chrono::seconds{1});
+    simulator.enable_introspection();
+    if (const auto path = std::getenv("DEVS_METRICS_TEXTFILE")) {
+        simulator.set_metrics_textfile(path);
+    }
+    if (const auto budget = std::getenv("DEVS_WALL_BUDGET")) {
+        simulator.set_wall_budget(std::chrono::duration<double>{parse_positive("DEVS_WALL_BUDGET", budget)});
+    }
+    if (const auto path = std::getenv("DEVS_STATE_HASHES")) {
+        const auto every = std::getenv("DEVS_STATE_HASH_EVERY");
+        simulator.record_state_hashes(path, every ? std::stoull(every) : 1000);
+    }
+    if (std::getenv("DEVS_REPLAY")) {
+        const auto every = std::getenv("DEVS_CHECKPOINT_EVERY");
+        simulator.set_checkpoint_interval((every ? std::stod(every) : 1.0) * Time::HOUR);
+    }
+}
+
+// replays the window FROM:TO (simulated hours) of DEVS_REPLAY verbosely from the nearest checkpoint
+void replay_window(Simulator& simulator) {
+    const auto window = std::getenv("DEVS_REPLAY");
+    if (!window) {
+        return;
+    }
+    const std::string value{window};
+    const auto separator = value.find(':');
+    if (separator == std::string::npos) {
+        throw std::runtime_error("Expected DEVS_REPLAY in the format FROM:TO (hours), got: " + value);
+    }
+    const auto from = std::stod(value.substr(0, separator)) * Time::HOUR;
+    const auto to = std::stod(value.substr(separator + 1)) * Time::HOUR;
+    std::cout << "Replaying the window [" << from << ", " << to << "]\n";
+    simulator.replay(from, to, Devs::Printer::ColoredVerbose<TimeT>::create());
+}
+
+// a run stopped by the wall budget only covers a part of the time window
+TimeT simulated_duration(const Simulator& simulator, const TimeParameters& time_params) {
+    if (simulator.budget_exceeded()) {
+        std::cout << "Wall budget exceeded, reporting partial statistics\n";
+        return simulator.time() - time_params.start;
+    }
+    return time_params.duration();
+}
+
 void print_stats(Simulator& simulator, const TimeT duration) {
 
     const auto product_counter_state =
@@ -1568,6 +2113,9 @@ void print_stats(Simulator& simulator, const TimeT duration) {
     for (const auto& [name, state] : stations) {
         std::cout << name << " station stats:\n";
         std::cout << "Servers:              " << state->servers().size() << "\n";
+        if (state->open_server_count() != state->servers().size()) {
+            std::cout << "Open servers:         " << state->open_server_count() << "\n";
+        }
         std::cout << "Currently serving:    " << state->busy_server_count() << "\n";
         std::cout << "Served customers:     " << state->served_customers() << "\n";
         std::cout << "Current queue size:   " << state->queue_size() << "\n";
@@ -1576,11 +2124,141 @@ void print_stats(Simulator& simulator, const TimeT duration) {
         std::cout << "Idle:                 " << state->total_idle_ratio(duration) * 100 << " %\n";
         std::cout << "Error:                " << state->total_error_ratio(duration) * 100 << " %\n";
         std::cout << "Error/Busy:           " << state->total_error_busy_ratio() * 100 << " %\n";
+        if (state->impatient_customers()) {
+            std::cout << "Reneged customers:    " << state->reneged_customers() << "\n";
+        }
         std::cout << "--------------------------------------\n";
     }
+    const auto coordinator_state = simulator.model()
+                                       .components()
+                                       ->at(CustomerCoordinator::MODEL_NAME)
+                                       ->state()
+                                       ->value<CustomerCoordinator::State>();
+    if (checkout_state.impatient_customers()) {
+        std::cout << "Balked customers:     " << coordinator_state.balked_customers() << "\n";
+    }
 }
 } // namespace Queue
 
+// closed Jackson network of single-server stations, a finished job moves to one of the two successors of its station
+namespace Network {
+constexpr size_t STATIONS = 20000;
+// offset of the second successor
+constexpr size_t SHORTCUT = 97;
+constexpr double SERVICE_RATE = 1.0;
+constexpr double SHORTCUT_CHANCE = 0.25;
+
+// routed to every successor, only the target accepts it
+using Job = size_t;
+
+std::string station_name(const size_t station) { return "station " + std::to_string(station); }
+
+class State {
+  public: // ctors, dtor
+    State(const size_t station, const size_t jobs)
+        : station_{station}, jobs_{0}, remaining_{Devs::Const::INF}, target_{station}, served_jobs_{0},
+          random_{Devs::Traits::mix(station)} {
+        for (size_t job = 0; job < jobs; ++job) {
+            add_job();
+        }
+    }
+
+  public: // friends
+    friend std::ostream& operator<<(std::ostream& os, const State& state) {
+        return os << "jobs: " << state.jobs_ << ", served: " << state.served_jobs_;
+    }
+
+  public: // methods
+    bool accepts(const Job job) const { return job == station_; }
+
+    void add_job() {
+        if (jobs_++ == 0) {
+            start_service();
+        }
+    }
+
+    void finish_job() {
+        --jobs_;
+        ++served_jobs_;
+        if (jobs_ > 0) {
+            start_service();
+        } else {
+            remaining_ = Devs::Const::INF;
+        }
+    }
+
+    void advance_time(const TimeT delta) {
+        if (jobs_ > 0) {
+            remaining_ -= delta;
+        }
+    }
+
+    TimeT remaining() const { return remaining_; }
+
+    Job target() const { return target_; }
+
+    size_t served_jobs() const { return served_jobs_; }
+
+  private: // methods
+    // a generator per station (see Devs::Random) would outweigh the rest of the state, a splitmix64 sequence is enough
+    double uniform() {
+        random_ += 0x9e3779b97f4a7c15ull;
+        return static_cast<double>(Devs::Traits::mix(random_) >> 11) * 0x1.0p-53;
+    }
+
+    void start_service() {
+        remaining_ = -std::log1p(-uniform()) / SERVICE_RATE;
+        target_ = (station_ + (uniform() < SHORTCUT_CHANCE ? SHORTCUT : 1)) % STATIONS;
+    }
+
+  private: // members
+    size_t station_;
+    size_t jobs_;
+    TimeT remaining_;
+    Job target_;
+    size_t served_jobs_;
+    std::uint64_t random_;
+};
+
+State delta_external(State state, const TimeT& elapsed, const Job& job) {
+    state.advance_time(elapsed);
+    if (state.accepts(job)) {
+        state.add_job();
+    }
+    return state;
+}
+
+State delta_internal(State state) {
+    state.advance_time(state.remaining());
+    state.finish_job();
+    return state;
+}
+
+Job out(const State& state) { return state.target(); }
+
+TimeT ta(const State& state) { return state.remaining(); }
+
+Compound create_model(const size_t jobs_per_station) {
+    Compound model{{}, {}};
+    for (size_t station = 0; station < STATIONS; ++station) {
+        const auto name = station_name(station);
+        model.components[name] =
+            Atomic<Job, Job, State>{State{station, jobs_per_station}, delta_external, delta_internal, out, ta};
+        model.influencers[name] = {{station_name((station + STATIONS - 1) % STATIONS), {}},
+                                   {station_name((station + STATIONS - SHORTCUT) % STATIONS), {}}};
+    }
+    return model;
+}
+
+size_t served_jobs(Simulator& simulator) {
+    size_t served{};
+    for (const auto& [_, p_station] : *simulator.model().components()) {
+        served += p_station->state()->value<State>().served_jobs();
+    }
+    return served;
+}
+} // namespace Network
+
 } // namespace _impl
 
 void minimal_atomic_simulation() {
@@ -1602,6 +2280,177 @@ void traffic_light_simulation() {
     simulator.run();
 }
 
+void traffic_light_grid_simulation() {
+    using namespace _impl::TrafficLight;
+    constexpr auto lights = 500;
+    constexpr auto start_time = 0.0;
+    constexpr auto end_time = 3600.0;
+
+    const auto input_count = Devs::Random::poisson(20)();
+    const auto rand_time = Devs::Random::uniform(start_time, end_time, {});
+    const auto rand_input = Devs::Random::uniform_int(0, static_cast<int>(Input::_ENUM_MEMBER_COUNT) - 1);
+    std::vector<std::pair<TimeT, Input>> inputs{};
+    for (int i = 0; i < input_count; ++i) {
+        inputs.emplace_back(rand_time(), static_cast<Input>(rand_input()));
+    }
+
+    // the tabulated and the handler based lights have to produce the same output sequence
+    const auto run = [&inputs](const std::string& label, const Devs::Model::AbstractModelFactory<TimeT>& light) {
+        Simulator simulator{"traffic light grid",
+                            create_grid_model(lights, light, true),
+                            start_time,
+                            end_time,
+                            0.001,
+                            Devs::Printer::Base<TimeT>::create()};
+        for (const auto& [time, input] : inputs) {
+            simulator.model().external_input(time, input, "Grid input: " + input_to_str(input));
+        }
+        std::vector<std::pair<TimeT, Output>> outputs{};
+        simulator.model().add_output_listener(
+            [&outputs](const std::string&, const TimeT& time, const Devs::Dynamic& value) {
+                outputs.emplace_back(time, value.value<Output>());
+            });
+        const auto time_start = std::chrono::steady_clock::now();
+        simulator.run();
+        const auto duration =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start);
+        std::cout << label << ": " << outputs.size() << " outputs in " << duration.count() << " milliseconds\n";
+        return outputs;
+    };
+
+    const auto finite_state = create_finite_state_model();
+    std::cout << "Tabulated " << finite_state.states << " discrete states x " << finite_state.inputs << " inputs\n";
+    const auto tabulated = run("Tabulated", finite_state);
+    const auto handlers = run("Handlers", create_model());
+    if (tabulated != handlers) {
+        throw std::runtime_error("Tabulated traffic lights diverged from the handler based ones");
+    }
+
+    // without output couplings nothing observes the lights, the periodic ones skip their transitions between inputs
+    const auto sample = [](const std::string& label, const Devs::Model::AbstractModelFactory<TimeT>& light,
+                           const std::vector<std::pair<TimeT, Input>>& inputs) {
+        Simulator simulator{"traffic light grid",
+                            create_grid_model(lights, light, false),
+                            start_time,
+                            end_time,
+                            0.001,
+                            Devs::Printer::Base<TimeT>::create()};
+        for (const auto& [time, input] : inputs) {
+            simulator.model().external_input(time, input, "Grid input: " + input_to_str(input));
+        }
+        const auto time_start = std::chrono::steady_clock::now();
+        simulator.run();
+        const auto duration =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start);
+        std::map<std::string, size_t> states{};
+        for (const auto& [_, p_light] : *simulator.model().components()) {
+            ++states[discrete_state_to_str(p_light->state()->value<State>())];
+        }
+        std::uint64_t transitions = 0;
+        simulator.model().activity([&transitions](const std::string&, const TimeT&, const std::uint64_t& count) {
+            transitions += count;
+        });
+        std::cout << label << ": " << transitions << " transitions, final state " << states.begin()->first << " in "
+                  << duration.count() << " milliseconds\n";
+        return std::make_pair(states, transitions);
+    };
+
+    auto stepped = create_model();
+    stepped.period = {};
+    const auto stepped_sample = sample("Unobserved stepped", stepped, inputs);
+    if (sample("Unobserved skip-ahead", create_model(), inputs) != stepped_sample) {
+        throw std::runtime_error("Skipped traffic light transitions diverged from the stepped ones");
+    }
+
+    // an input consuming the whole time advance, exactly on a transition time of the lights
+    const std::vector<std::pair<TimeT, Input>> coincident{{31.0, Input::POWER_ON}};
+    const auto coincident_sample = sample("Unobserved coincident stepped", stepped, coincident);
+    if (sample("Unobserved coincident skip-ahead", create_model(), coincident) != coincident_sample) {
+        throw std::runtime_error("Skipped traffic light transitions diverged from the stepped ones on an input");
+    }
+
+    // the outputs of a leader toggle the unobserved follower exactly on its own transition times, the follower has to
+    // order the skipped transition before the input like the stepped run does
+    const auto follow = [](const Devs::Model::AbstractModelFactory<TimeT>& follower) {
+        Compound compound{{}, {}};
+        compound.components.emplace("leader", create_model());
+        compound.components.emplace("follower", follower);
+        compound.influencers["follower"].emplace(
+            "leader", Devs::Model::Transformer{[](const Devs::Dynamic&) { return Devs::Dynamic{Input::MODE_TOGGLE}; }});
+        Simulator simulator{
+            "traffic light pair", compound, start_time, end_time, 0.001, Devs::Printer::Base<TimeT>::create()};
+        simulator.run();
+        std::uint64_t transitions = 0;
+        simulator.model().activity([&transitions](const std::string&, const TimeT&, const std::uint64_t& count) {
+            transitions += count;
+        });
+        const auto state = simulator.model().components()->at("follower")->state()->value<State>();
+        return std::make_pair(discrete_state_to_str(state), transitions);
+    };
+    const auto followed = follow(stepped);
+    if (follow(create_model()) != followed) {
+        throw std::runtime_error("Skipped traffic light transitions diverged from the stepped ones on leader inputs");
+    }
+    std::cout << "Coincident inputs: " << followed.second << " transitions, follower state " << followed.first << "\n";
+}
+
+void traffic_light_batched_outputs_simulation() {
+    using namespace _impl::TrafficLight;
+    using Batch = std::vector<Devs::Model::Output<TimeT>>;
+    constexpr auto lights = 500;
+    constexpr size_t capacity = 256;
+    constexpr auto start_time = 0.0;
+    constexpr auto end_time = 3600.0;
+
+    // the lights receive the same inputs, they switch their colors simultaneously
+    Simulator simulator{"traffic light grid",
+                        create_grid_model(lights, create_model(), true),
+                        start_time,
+                        end_time,
+                        0.001,
+                        Devs::Printer::Base<TimeT>::create()};
+    const auto input_count = Devs::Random::poisson(20)();
+    const auto rand_time = Devs::Random::uniform(start_time, end_time, {});
+    const auto rand_input = Devs::Random::uniform_int(0, static_cast<int>(Input::_ENUM_MEMBER_COUNT) - 1);
+    for (int i = 0; i < input_count; ++i) {
+        const auto input = static_cast<Input>(rand_input());
+        simulator.model().external_input(rand_time(), input, "Grid input: " + input_to_str(input));
+    }
+
+    // output sequence received by a listener invoked per output and by listeners invoked per batch
+    struct Consumer {
+        std::string name;
+        size_t calls;
+        std::vector<std::pair<TimeT, Output>> outputs;
+    };
+    std::array<Consumer, 3> consumers{{{"Per output", 0, {}},
+                                       {"Per timestep", 0, {}},
+                                       {std::to_string(capacity) + "-output buffer", 0, {}}}};
+    simulator.model().add_output_listener([&](const std::string&, const TimeT& time, const Devs::Dynamic& value) {
+        ++consumers[0].calls;
+        consumers[0].outputs.emplace_back(time, value.value<Output>());
+    });
+    for (size_t idx = 1; idx < consumers.size(); ++idx) {
+        simulator.model().add_batch_output_listener(
+            [&consumer = consumers[idx]](const std::string&, const Batch& outputs) {
+                ++consumer.calls;
+                for (const auto& output : outputs) {
+                    consumer.outputs.emplace_back(output.time, output.value.value<Output>());
+                }
+            },
+            idx == 1 ? 0 : capacity);
+    }
+    simulator.run();
+
+    std::cout << "Traffic light outputs (" << consumers[0].outputs.size() << " outputs):\n";
+    for (const auto& consumer : consumers) {
+        std::cout << consumer.name << " listener: " << consumer.calls << " calls\n";
+        if (consumer.outputs != consumers[0].outputs) {
+            throw std::runtime_error("The batched outputs differ from the outputs listened per output");
+        }
+    }
+}
+
 void queue_simulation_short() {
     using namespace _impl::Queue;
     // simulation time window
@@ -1629,6 +2478,155 @@ void queue_simulation_short() {
     print_stats(simulator, time_params.duration());
 }
 
+void queue_simulation_impatient() {
+    using namespace _impl::Queue;
+    // simulation time window
+    const TimeParameters time_params{0.0, 8 * Time::HOUR};
+    // queue-short parameters with fewer checkouts than the arrivals need
+    const auto parameters = Parameters{
+        time_params,
+        {time_params.normalize_rate(100 * time_params.duration_hours()), 0.5, 0.75},
+        {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+        {time_params.normalize_rate(100 * time_params.duration_hours())},
+        {
+            1,
+            time_params.normalize_rate(20 * time_params.duration_hours()),
+            0.05,
+            time_params.normalize_rate(10 * time_params.duration_hours()),
+        },
+        {4, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+         time_params.normalize_rate(30 * time_params.duration_hours()),
+         time_params.normalize_rate(45 * time_params.duration_hours())},
+        // 10 minutes of patience on average, nobody joins a queue of 6
+        PatienceParameters{1.0 / (10 * Time::MINUTE), 6},
+    };
+
+    Simulator simulator{"shop queue system", create_model(parameters),
+                        time_params.start,   time_params.end,
+                        Time::EPS,           Devs::Printer::Base<TimeT>::create()};
+    setup_inputs_outputs(simulator, parameters, false);
+    simulator.run();
+    print_stats(simulator, time_params.duration());
+}
+
+void queue_simulation_staffing() {
+
+    using namespace _impl::Queue;
+    constexpr auto peak_per_hour = 200.0;
+    // simulation time window
+    const TimeParameters time_params{0.0, 24 * Time::HOUR};
+    // queue-daily parameters for a single day with one checkout open outside of the staffing changes
+    const auto parameters = Parameters{
+        time_params,
+        {0.0, 0.5, 0.75},
+        {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+        {time_params.normalize_rate(100 * time_params.duration_hours())},
+        {
+            1,
+            time_params.normalize_rate(20 * time_params.duration_hours()),
+            0.05,
+            time_params.normalize_rate(10 * time_params.duration_hours()),
+        },
+        {6, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+         time_params.normalize_rate(30 * time_params.duration_hours()),
+         time_params.normalize_rate(45 * time_params.duration_hours())},
+    };
+
+    using Schedule = Devs::Model::ParameterSchedule<TimeT>;
+    const auto shift = [](Schedule schedule, const TimeT open, const TimeT close, const size_t servers) {
+        return schedule.at(open * Time::HOUR, Checkout::MODEL_NAME, Checkout::staffing(servers), "checkouts opened")
+            .at(close * Time::HOUR, Checkout::MODEL_NAME, Checkout::staffing(1), "checkouts closed");
+    };
+    const std::vector<std::pair<std::string, Schedule>> schedules{
+        {"1 checkout", Schedule{}},
+        {"3 checkouts 10:00-20:00", shift(Schedule{}, 10, 20, 3)},
+        {"2 checkouts 08:00-21:00", shift(Schedule{}, 8, 21, 2)},
+        {"4 checkouts 16:00-19:00", shift(Schedule{}, 16, 19, 4)},
+    };
+
+    Simulator simulator{"shop queue system", create_model(parameters),
+                        time_params.start,   time_params.end,
+                        Time::EPS,           Devs::Printer::Base<TimeT>::create()};
+    setup_daily_inputs(simulator, parameters, peak_per_hour);
+    simulator.enable_reset();
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "Checkout staffing schedules:\n";
+    for (size_t idx = 0; idx < schedules.size(); ++idx) {
+        // the built model is reused, every schedule sees the same arrivals and service times
+        if (idx > 0) {
+            simulator.reset();
+        }
+        simulator.set_parameter_schedule(schedules[idx].second);
+        simulator.run();
+        const auto checkout =
+            simulator.model().components()->at(Checkout::MODEL_NAME)->state()->value<Checkout::State>();
+        const auto self_checkout =
+            simulator.model().components()->at(SelfCheckout::MODEL_NAME)->state()->value<SelfCheckout::State>();
+        std::cout << schedules[idx].first << ": served " << checkout.served_customers() << " + "
+                  << self_checkout.served_customers() << ", average checkout queue "
+                  << checkout.average_queue_size(time_params.duration()) << ", average self checkout queue "
+                  << self_checkout.average_queue_size(time_params.duration()) << "\n";
+    }
+}
+
+void queue_simulation_forecast() {
+
+    using namespace _impl::Queue;
+    constexpr auto peak_per_hour = 200.0;
+    // simulation time window
+    const TimeParameters time_params{0.0, 24 * Time::HOUR};
+    // queue-daily parameters for a single day
+    const auto parameters = Parameters{
+        time_params,
+        {0.0, 0.5, 0.75},
+        {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+        {time_params.normalize_rate(100 * time_params.duration_hours())},
+        {
+            3,
+            time_params.normalize_rate(20 * time_params.duration_hours()),
+            0.05,
+            time_params.normalize_rate(10 * time_params.duration_hours()),
+        },
+        {6, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+         time_params.normalize_rate(30 * time_params.duration_hours()),
+         time_params.normalize_rate(45 * time_params.duration_hours())},
+    };
+
+    auto model = create_model(parameters);
+    model.components[Forecast::MODEL_NAME] = Forecast::create_model(parameters.checkout);
+    model.influencers[Forecast::MODEL_NAME] = {{Checkout::MODEL_NAME, {}}};
+    Simulator simulator{"shop queue system", model, time_params.start, time_params.end, Time::EPS,
+                        Devs::Printer::Base<TimeT>::create()};
+    setup_daily_inputs(simulator, parameters, peak_per_hour);
+    simulator.enable_reset();
+
+    // the same day (reset) with the estimates computed on the simulation thread and deferred to the pool
+    Devs::Parallel::ThreadPool pool{std::max(2u, std::thread::hardware_concurrency()) - 1, false};
+    std::cout << std::setprecision(2) << std::fixed;
+    std::optional<std::pair<size_t, double>> inline_forecasts{};
+    for (const auto p_pool : {static_cast<Devs::Parallel::ThreadPool*>(nullptr), &pool}) {
+        if (p_pool != nullptr) {
+            simulator.reset();
+        }
+        simulator.set_parameter_schedule(Devs::Model::ParameterSchedule<TimeT>{}.at(
+            time_params.start, Forecast::MODEL_NAME, Forecast::computation_pool(p_pool), "computation pool"));
+        const auto start = std::chrono::steady_clock::now();
+        simulator.run();
+        const std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+        const auto forecast =
+            simulator.model().components()->at(Forecast::MODEL_NAME)->state()->value<Forecast::State>();
+        std::cout << (p_pool != nullptr ? "Deferred to " + std::to_string(pool.size()) + " workers" : "Inline")
+                  << ": " << forecast.forecasts() << " forecasts, mean checkout waiting "
+                  << forecast.mean_forecast() / Time::MINUTE << " min, wall " << wall.count() << " ms\n";
+        if (!inline_forecasts) {
+            inline_forecasts.emplace(forecast.forecasts(), forecast.mean_forecast());
+        } else if (*inline_forecasts != std::make_pair(forecast.forecasts(), forecast.mean_forecast())) {
+            throw std::runtime_error("Deferred forecasts diverged from the inline ones");
+        }
+    }
+}
+
 void queue_simulation_long() {
 
     using namespace _impl::Queue;
@@ -1653,10 +2651,12 @@ void queue_simulation_long() {
 
     Simulator simulator{"shop queue system", create_model(parameters),
                         time_params.start,   time_params.end,
-                        Time::EPS,           Devs::Printer::Base<TimeT>::create()};
+                        Time::EPS,           Devs::Printer::Progress<TimeT>::create()};
     setup_inputs_outputs(simulator, parameters, false);
+    setup_progress(simulator);
     simulator.run();
-    print_stats(simulator, time_params.duration());
+    print_stats(simulator, simulated_duration(simulator, time_params));
+    replay_window(simulator);
 }
 
 void queue_simulation_large() {
@@ -1688,4 +2688,208 @@ void queue_simulation_large() {
     simulator.run();
     print_stats(simulator, time_params.duration());
 }
+
+void queue_simulation_daily() {
+
+    using namespace _impl::Queue;
+    constexpr auto peak_per_hour = 200.0;
+    // simulation time window
+    const TimeParameters time_params{0.0, 7 * 24 * Time::HOUR};
+    // queue parameters, the arrivals follow the daily profile instead of the constant rate
+    const auto parameters = Parameters{
+        time_params,
+        {0.0, 0.5, 0.75},
+        {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+        {time_params.normalize_rate(100 * time_params.duration_hours())},
+        {
+            3,
+            time_params.normalize_rate(20 * time_params.duration_hours()),
+            0.05,
+            time_params.normalize_rate(10 * time_params.duration_hours()),
+        },
+        {6, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+         time_params.normalize_rate(30 * time_params.duration_hours()),
+         time_params.normalize_rate(45 * time_params.duration_hours())},
+    };
+
+    Simulator simulator{"shop queue system", create_model(parameters),
+                        time_params.start,   time_params.end,
+                        Time::EPS,           Devs::Printer::Progress<TimeT>::create()};
+    setup_daily_inputs(simulator, parameters, peak_per_hour);
+    setup_progress(simulator);
+    simulator.run();
+    print_stats(simulator, simulated_duration(simulator, time_params));
+    replay_window(simulator);
+}
+
+void queue_simulation_replications() {
+
+    using namespace _impl::Queue;
+    constexpr size_t replications = 16;
+    // simulation time window
+    const TimeParameters time_params{0.0, 8 * Time::HOUR};
+    // queue parameters
+    const auto parameters = Parameters{
+        time_params,
+        {time_params.normalize_rate(100 * time_params.duration_hours()), 0.5, 0.75},
+        {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+        {time_params.normalize_rate(100 * time_params.duration_hours())},
+        {
+            3,
+            time_params.normalize_rate(20 * time_params.duration_hours()),
+            0.05,
+            time_params.normalize_rate(10 * time_params.duration_hours()),
+        },
+        {6, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+         time_params.normalize_rate(30 * time_params.duration_hours()),
+         time_params.normalize_rate(45 * time_params.duration_hours())},
+    };
+
+    Devs::Parallel::ThreadPool pool{};
+    // each replication is seeded from its index, a seeded replication is reproduced regardless of its worker
+    const auto report = Devs::Parallel::replicate(pool, replications, [&parameters](const size_t replication) {
+        // the whole simulator is built on the worker, keeping its memory local to the worker's node
+        Simulator simulator{"shop queue system", create_model(parameters),
+                            parameters.time.start, parameters.time.end,
+                            Time::EPS,             Devs::Printer::Base<TimeT>::create()};
+        setup_inputs_outputs(simulator, parameters, false);
+        simulator.run();
+        const auto checkout =
+            simulator.model().components()->at(Checkout::MODEL_NAME)->state()->value<Checkout::State>();
+        const auto self_checkout =
+            simulator.model().components()->at(SelfCheckout::MODEL_NAME)->state()->value<SelfCheckout::State>();
+        return std::make_pair(replication, checkout.served_customers() + self_checkout.served_customers());
+    });
+
+    double served_sum{};
+    for (const auto& [_, served] : report.results) {
+        served_sum += served;
+    }
+    const auto [fewest, most] = std::minmax_element(report.results.begin(), report.results.end(),
+                                                    [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "Queue system replications (" << pool.size() << " workers):\n";
+    std::cout << "Average served customers: " << served_sum / static_cast<double>(report.results.size()) << "\n";
+    std::cout << "Fewest served customers: " << fewest->second << " (replication " << fewest->first << ")\n";
+    std::cout << "Most served customers: " << most->second << " (replication " << most->first << ")\n";
+    std::cout << report.to_string();
+}
+
+void queue_what_if_simulation() {
+
+    using namespace _impl::Queue;
+    using Clock = std::chrono::steady_clock;
+    const TimeParameters time_params{0.0, 4 * Time::HOUR};
+    // a point is (self checkouts, arrival factor), the KPIs are (served customers per hour, average checkout queue,
+    // average self checkout queue)
+    const auto simulate = [&time_params](const Devs::Surrogate::Point& point) -> Devs::Surrogate::Kpis {
+        const auto self_checkouts = static_cast<size_t>(std::lround(point[0]));
+        const auto parameters = Parameters{
+            time_params,
+            {time_params.normalize_rate(point[1] * 100 * time_params.duration_hours()), 0.5, 0.75},
+            {2, time_params.normalize_rate(50 * time_params.duration_hours())},
+            {time_params.normalize_rate(100 * time_params.duration_hours())},
+            {
+                3,
+                time_params.normalize_rate(20 * time_params.duration_hours()),
+                0.05,
+                time_params.normalize_rate(10 * time_params.duration_hours()),
+            },
+            {self_checkouts, time_params.normalize_rate(12 * time_params.duration_hours()), 0.3,
+             time_params.normalize_rate(30 * time_params.duration_hours()),
+             time_params.normalize_rate(45 * time_params.duration_hours())},
+        };
+        Simulator simulator{"shop queue system", create_model(parameters),
+                            time_params.start,   time_params.end,
+                            Time::EPS,           Devs::Printer::Base<TimeT>::create()};
+        setup_inputs_outputs(simulator, parameters, false);
+        simulator.run();
+        const auto checkout =
+            simulator.model().components()->at(Checkout::MODEL_NAME)->state()->value<Checkout::State>();
+        const auto self_checkout =
+            simulator.model().components()->at(SelfCheckout::MODEL_NAME)->state()->value<SelfCheckout::State>();
+        return {static_cast<double>(checkout.served_customers() + self_checkout.served_customers()) /
+                    time_params.duration_hours(),
+                checkout.average_queue_size(time_params.duration()),
+                self_checkout.average_queue_size(time_params.duration())};
+    };
+
+    std::vector<Devs::Surrogate::Point> sweep{};
+    for (const auto self_checkouts : {3.0, 5.0, 7.0, 9.0}) {
+        for (const auto arrival_factor : {0.8, 1.0, 1.2, 1.4}) {
+            sweep.push_back({self_checkouts, arrival_factor});
+        }
+    }
+    Devs::Parallel::ThreadPool pool{};
+    Devs::Surrogate::Metamodel metamodel{simulate};
+    const auto report = metamodel.train(pool, sweep);
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "Queue system metamodel trained on " << sweep.size() << " runs in " << report.wall_seconds
+              << " s (length scale " << metamodel.process().length_scale() << ", noise "
+              << metamodel.process().noise() << ")\n";
+    const std::vector<Devs::Surrogate::Point> queries{{6.0, 1.2}, {7.0, 1.2}, {4.0, 0.9}, {12.0, 1.2}, {6.0, 2.0}};
+    constexpr size_t repetitions = 1000;
+    const auto predict_start = Clock::now();
+    for (size_t idx = 0; idx < repetitions; ++idx) {
+        for (const auto& query : queries) {
+            metamodel.predict(query);
+        }
+    }
+    const std::chrono::duration<double, std::micro> predict_time = Clock::now() - predict_start;
+    const auto answers = metamodel.answer(pool, queries);
+    for (size_t idx = 0; idx < queries.size(); ++idx) {
+        const auto& answer = answers[idx];
+        std::cout << queries[idx][0] << " self checkouts at " << queries[idx][1]
+                  << "x arrivals: served/h = " << answer.mean[0] << ", checkout queue = " << answer.mean[1]
+                  << ", self checkout queue = " << answer.mean[2];
+        if (answer.simulated) {
+            std::cout << " (simulated)\n";
+        } else {
+            std::cout << " (+/- " << answer.stddev[0] << ", " << answer.stddev[1] << ", " << answer.stddev[2]
+                      << ")\n";
+        }
+    }
+    std::cout << "Metamodel query: " << predict_time.count() / (repetitions * queries.size()) << " us, "
+              << metamodel.simulations() << " queries simulated\n";
+}
+
+void network_layout_cache_simulation() {
+
+    using namespace _impl::Network;
+    using Clock = std::chrono::steady_clock;
+    constexpr TimeT end_time = 10.0;
+    const auto tmpdir = std::getenv("TMPDIR");
+    const auto path = std::string{tmpdir != nullptr ? tmpdir : "/tmp"} + "/devs-network.layout";
+    const auto milliseconds = [](const Clock::time_point from) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+    };
+    const auto model = create_model(1);
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "Closed Jackson network of " << STATIONS << " stations:\n";
+    std::optional<size_t> expected{};
+    // resolved without a cache, then on the first start (missing cache file) and on a later start (cached layout)
+    std::remove(path.c_str());
+    for (const auto start : {"Resolved", "Cache written", "Cache read"}) {
+        const auto layout_start = Clock::now();
+        const auto layout = std::string{start} == "Resolved" ? Devs::LayoutCache::resolve(model)
+                                                              : Devs::LayoutCache::cached(path, model);
+        const auto layout_ms = milliseconds(layout_start);
+        const auto build_start = Clock::now();
+        Simulator simulator{"network", model, layout, 0.0, end_time, 0.001, Devs::Printer::Base<TimeT>::create()};
+        const auto build_ms = milliseconds(build_start);
+        const auto run_start = Clock::now();
+        simulator.run();
+        const auto run_ms = milliseconds(run_start);
+        const auto served = served_jobs(simulator);
+        std::cout << start << (layout.cached ? " (cached)" : "") << ": layout " << layout_ms << " ms, build "
+                  << build_ms << " ms, run " << run_ms << " ms, served jobs " << served << "\n";
+        if (expected && *expected != served) {
+            throw std::runtime_error("The network built from the cached layout diverged from the resolved one");
+        }
+        expected = served;
+    }
+}
 } // namespace Examples
\ No newline at end of file
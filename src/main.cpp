@@ -5,6 +5,7 @@
  */
 
 #include <chrono>
+#include <cstdlib>
 #include <devs/examples.hpp>
 #include <devs/lib.hpp>
 #include <iostream>
@@ -14,9 +15,18 @@ std::unordered_map<std::string, std::function<void()>> create_examples() {
     return {{"minimal-atomic", Examples::minimal_atomic_simulation},
             {"minimal-compound", Examples::minimal_compound_simulation},
             {"traffic-light", Examples::traffic_light_simulation},
+            {"traffic-light-grid", Examples::traffic_light_grid_simulation},
+            {"traffic-light-batched", Examples::traffic_light_batched_outputs_simulation},
             {"queue-short", Examples::queue_simulation_short},
+            {"queue-impatient", Examples::queue_simulation_impatient},
+            {"queue-staffing", Examples::queue_simulation_staffing},
+            {"queue-forecast", Examples::queue_simulation_forecast},
             {"queue-long", Examples::queue_simulation_long},
-            {"queue-large", Examples::queue_simulation_large}};
+            {"queue-large", Examples::queue_simulation_large},
+            {"queue-daily", Examples::queue_simulation_daily},
+            {"queue-replications", Examples::queue_simulation_replications},
+            {"queue-what-if", Examples::queue_what_if_simulation},
+            {"network-layout-cache", Examples::network_layout_cache_simulation}};
 }
 
 std::vector<std::string> get_args(int argc, char* argv[]) {
@@ -54,7 +64,8 @@ std::optional<std::vector<std::string>> parse_arguments(const std::vector<std::s
 void print_help(const std::vector<std::string>& example_names) {
     std::cout << "Demo application for the DEVS simulation library (SNT 2023)\n"
               << "Usage: \n"
-              << "    devs [-h | --help] [<example>...]\n\n";
+              << "    devs [-h | --help] [<example>...]\n"
+              << "    devs --compare-hashes <state hash file> <state hash file>\n\n";
     std::cout << "Available examples: \n";
     for (const auto& example : example_names) {
         std::cout << " - " << example << "\n";
@@ -80,10 +91,30 @@ void run_examples(const std::unordered_map<std::string, std::function<void()>> e
     }
 }
 
+int compare_hashes(const std::string& left, const std::string& right) {
+    if (const auto divergence = Devs::Divergence::compare(left, right)) {
+        std::cout << divergence->to_string() << "\n";
+        return 1;
+    }
+    std::cout << "State hashes match\n";
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
 
     try {
         const auto args = get_args(argc, argv);
+        if (!args.empty() && args[0] == "--compare-hashes") {
+            if (args.size() != 3) {
+                std::cerr << "Expected two state hash files to compare\n";
+                return 1;
+            }
+            return compare_hashes(args[1], args[2]);
+        }
+        // reproducible runs, required for comparing state hashes
+        if (const auto seed = std::getenv("DEVS_SEED")) {
+            Devs::Random::set_default_seed(std::stoull(seed));
+        }
         const auto examples = create_examples();
         std::vector<std::string> example_names{};
         for (const auto& example : examples) {